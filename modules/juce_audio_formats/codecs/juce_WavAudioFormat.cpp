@@ -71,6 +71,18 @@ namespace WavFileHelpers
 {
     inline int chunkName (const char* const name) noexcept   { return (int) ByteOrder::littleEndianInt (name); }
 
+    /* A compile-time equivalent of chunkName(), which lets the header scan
+       switch directly on the chunk IDs rather than comparing them one-by-one.
+    */
+    template <char c1, char c2, char c3, char c4>
+    struct NamedChunk
+    {
+        enum { ID = (int) (((uint32) (uint8) c1)
+                          | (((uint32) (uint8) c2) << 8)
+                          | (((uint32) (uint8) c3) << 16)
+                          | (((uint32) (uint8) c4) << 24)) };
+    };
+
     #if JUCE_MSVC
      #pragma pack (push, 1)
     #endif
@@ -108,9 +120,17 @@ namespace WavFileHelpers
 
         static MemoryBlock createFrom (const StringPairArray& values)
         {
-            const size_t sizeNeeded = sizeof (BWAVChunk) + values [WavAudioFormat::bwavCodingHistory].getNumBytesAsUTF8();
-            MemoryBlock data ((sizeNeeded + 3) & ~3);
-            data.fillWith (0);
+            // This is looked up once and the byte count remembered, so that the
+            // history string doesn't get searched for and scanned a second time
+            // when it's copied below.
+            const String& codingHistory = values [WavAudioFormat::bwavCodingHistory];
+            const size_t codingHistorySize = codingHistory.getNumBytesAsUTF8();
+
+            const size_t sizeNeeded = sizeof (BWAVChunk) + codingHistorySize;
+
+            // (asking the constructor for cleared memory gets zeroed pages
+            // straight from the allocator, instead of a malloc plus a memset)
+            MemoryBlock data ((sizeNeeded + 3) & ~3, true);
 
             BWAVChunk* b = (BWAVChunk*) data.getData();
 
@@ -126,7 +146,7 @@ namespace WavFileHelpers
             b->timeRefLow = ByteOrder::swapIfBigEndian ((uint32) (time & 0xffffffff));
             b->timeRefHigh = ByteOrder::swapIfBigEndian ((uint32) (time >> 32));
 
-            values [WavAudioFormat::bwavCodingHistory].copyToUTF8 (b->codingHistory, 0x7fffffff);
+            codingHistory.copyToUTF8 (b->codingHistory, codingHistorySize + 1);
 
             if (b->description[0] != 0
                 || b->originator[0] != 0
@@ -174,11 +194,6 @@ namespace WavFileHelpers
             values.set (name, String (ByteOrder::swapIfBigEndian (val)));
         }
 
-        static void setValue (StringPairArray& values, int prefix, const char* name, uint32 val)
-        {
-            setValue (values, "Loop" + String (prefix) + name, val);
-        }
-
         void copyTo (StringPairArray& values, const int totalSize) const
         {
             setValue (values, "Manufacturer",      manufacturer);
@@ -191,17 +206,23 @@ namespace WavFileHelpers
             setValue (values, "NumSampleLoops",    numSampleLoops);
             setValue (values, "SamplerData",       samplerData);
 
-            for (int i = 0; i < (int) numSampleLoops; ++i)
-            {
-                if ((uint8*) (loops + (i + 1)) > ((uint8*) this) + totalSize)
-                    break;
+            // Work out once how many loops actually fit inside the chunk,
+            // rather than re-checking the bound inside the loop.
+            const int numLoops = jmin ((int) ByteOrder::swapIfBigEndian (numSampleLoops),
+                                       (totalSize - (int) offsetof (SMPLChunk, loops)) / (int) sizeof (SampleLoop));
 
-                setValue (values, i, "Identifier", loops[i].identifier);
-                setValue (values, i, "Type",       loops[i].type);
-                setValue (values, i, "Start",      loops[i].start);
-                setValue (values, i, "End",        loops[i].end);
-                setValue (values, i, "Fraction",   loops[i].fraction);
-                setValue (values, i, "PlayCount",  loops[i].playCount);
+            for (int i = 0; i < numLoops; ++i)
+            {
+                // Building the shared prefix once per loop avoids most of the
+                // temporary-string traffic that formatting each key would cause.
+                const String prefix ("Loop" + String (i));
+
+                setValue (values, prefix + "Identifier", loops[i].identifier);
+                setValue (values, prefix + "Type",       loops[i].type);
+                setValue (values, prefix + "Start",      loops[i].start);
+                setValue (values, prefix + "End",        loops[i].end);
+                setValue (values, prefix + "Fraction",   loops[i].fraction);
+                setValue (values, prefix + "PlayCount",  loops[i].playCount);
             }
         }
 
@@ -537,6 +558,400 @@ namespace WavFileHelpers
     #if JUCE_MSVC
      #pragma pack (pop)
     #endif
+
+    //==============================================================================
+    /* Reads a metadata chunk into a zero-padded scratch buffer. Typical chunks
+       are well under a couple of KB, so these normally live on the stack, and
+       the heap is only touched for unusually large ones. Any part of the buffer
+       beyond the bytes actually read is zeroed, so short or truncated chunks
+       behave as if the missing fields were blank.
+    */
+    struct MetadataChunkBuffer
+    {
+        MetadataChunkBuffer (InputStream& input, const uint32 length, const size_t structSize)
+        {
+            const size_t sizeNeeded = jmax ((size_t) length + 1, structSize);
+
+            if (sizeNeeded <= sizeof (stackBuffer))
+            {
+                buffer = stackBuffer;
+            }
+            else
+            {
+                heapBuffer.malloc (sizeNeeded);
+                buffer = heapBuffer;
+            }
+
+            const int bytesRead = jmax (0, input.read (buffer, (int) length));
+            zeromem (buffer + bytesRead, sizeNeeded - (size_t) bytesRead);
+        }
+
+        template <typename ChunkType>
+        const ChunkType* get() const noexcept   { return reinterpret_cast <const ChunkType*> (buffer); }
+
+    private:
+        char* buffer;
+        HeapBlock<char> heapBuffer;
+        char stackBuffer [2048];
+
+        JUCE_DECLARE_NON_COPYABLE (MetadataChunkBuffer)
+    };
+
+    //==============================================================================
+   #if JUCE_BIG_ENDIAN
+    /* Swaps a whole buffer of 16 or 32-bit words to native byte order in a single
+       sequential pass. On big-endian targets this is cheaper than swapping each
+       sample individually inside the conversion loops, and the simple loop is one
+       that the compiler can vectorise.
+    */
+    static void byteSwapBuffer (void* const buffer, const int numWords, const int bytesPerWord) noexcept
+    {
+        if (bytesPerWord == 2)
+        {
+            uint16* const d = static_cast <uint16*> (buffer);
+
+            for (int i = 0; i < numWords; ++i)
+                d[i] = ByteOrder::swap (d[i]);
+        }
+        else if (bytesPerWord == 4)
+        {
+            uint32* const d = static_cast <uint32*> (buffer);
+
+            for (int i = 0; i < numWords; ++i)
+                d[i] = ByteOrder::swap (d[i]);
+        }
+    }
+   #endif
+
+    //==============================================================================
+   #if JUCE_USE_SSE_INTRINSICS
+    static bool sse2Present = false;
+
+    static bool isSSE2Available() noexcept
+    {
+        if (sse2Present)
+            return true;
+
+        sse2Present = SystemStats::hasSSE2();
+        return sse2Present;
+    }
+
+    /* Conversions big enough to blow through the last-level cache (e.g. an
+       offline render pulling a whole file through the memory-mapped read path)
+       gain nothing from having the destination channels linger in cache, and
+       evict data the caller still wants - so above this size, the deinterleave
+       loops below switch to non-temporal stores. The streaming stores need
+       16-byte alignment, so any leading unaligned frames are peeled off first,
+       and the loops finish with an sfence.
+    */
+    enum { minimumFramesForNonTemporalStores = 256 * 1024 };
+
+    /* Deinterleaves 16-bit stereo frames into two int32 destination channels,
+       shifting each sample up into the top 16 bits - the same conversion as
+       ReadHelper<Int32, Int16, LittleEndian>, but four frames per iteration.
+       (SSE implies a little-endian target, so no byteswap is needed here.)
+    */
+    static void deinterleaveStereo16 (const void* sourceData, int* left, int* right, int numFrames) noexcept
+    {
+        const short* src = static_cast <const short*> (sourceData);
+        const __m128i zero = _mm_setzero_si128();
+        int i = 0;
+
+        if (numFrames >= minimumFramesForNonTemporalStores
+             && (((pointer_sized_int) left) & 15) == (((pointer_sized_int) right) & 15))
+        {
+            while (i < numFrames && (((pointer_sized_int) (left + i)) & 15) != 0)
+            {
+                left[i]  = ((int) src[2 * i])     << 16;
+                right[i] = ((int) src[2 * i + 1]) << 16;
+                ++i;
+            }
+
+            for (; i + 4 <= numFrames; i += 4)
+            {
+                const __m128i v  = _mm_loadu_si128 (reinterpret_cast <const __m128i*> (src + 2 * i));
+                const __m128i lo = _mm_unpacklo_epi16 (zero, v);
+                const __m128i hi = _mm_unpackhi_epi16 (zero, v);
+
+                const __m128 l = _mm_shuffle_ps (_mm_castsi128_ps (lo), _mm_castsi128_ps (hi), _MM_SHUFFLE (2, 0, 2, 0));
+                const __m128 r = _mm_shuffle_ps (_mm_castsi128_ps (lo), _mm_castsi128_ps (hi), _MM_SHUFFLE (3, 1, 3, 1));
+
+                _mm_stream_si128 (reinterpret_cast <__m128i*> (left + i),  _mm_castps_si128 (l));
+                _mm_stream_si128 (reinterpret_cast <__m128i*> (right + i), _mm_castps_si128 (r));
+            }
+
+            _mm_sfence();
+        }
+
+        for (; i + 4 <= numFrames; i += 4)
+        {
+            const __m128i v  = _mm_loadu_si128 (reinterpret_cast <const __m128i*> (src + 2 * i));
+            const __m128i lo = _mm_unpacklo_epi16 (zero, v);  // (L0, R0, L1, R1) << 16
+            const __m128i hi = _mm_unpackhi_epi16 (zero, v);  // (L2, R2, L3, R3) << 16
+
+            const __m128 l = _mm_shuffle_ps (_mm_castsi128_ps (lo), _mm_castsi128_ps (hi), _MM_SHUFFLE (2, 0, 2, 0));
+            const __m128 r = _mm_shuffle_ps (_mm_castsi128_ps (lo), _mm_castsi128_ps (hi), _MM_SHUFFLE (3, 1, 3, 1));
+
+            _mm_storeu_si128 (reinterpret_cast <__m128i*> (left + i),  _mm_castps_si128 (l));
+            _mm_storeu_si128 (reinterpret_cast <__m128i*> (right + i), _mm_castps_si128 (r));
+        }
+
+        for (; i < numFrames; ++i)
+        {
+            left[i]  = ((int) src[2 * i])     << 16;
+            right[i] = ((int) src[2 * i + 1]) << 16;
+        }
+    }
+
+    /* Splits interleaved 32-bit stereo frames into two planar channels, four
+       frames per iteration. As this is a pure bitwise deinterleave, it's used
+       for both int32 and float32 data.
+    */
+    static void deinterleaveStereo32 (const void* sourceData, int* left, int* right, int numFrames) noexcept
+    {
+        const int* src = static_cast <const int*> (sourceData);
+        int i = 0;
+
+        if (numFrames >= minimumFramesForNonTemporalStores
+             && (((pointer_sized_int) left) & 15) == (((pointer_sized_int) right) & 15))
+        {
+            while (i < numFrames && (((pointer_sized_int) (left + i)) & 15) != 0)
+            {
+                left[i]  = src[2 * i];
+                right[i] = src[2 * i + 1];
+                ++i;
+            }
+
+            for (; i + 4 <= numFrames; i += 4)
+            {
+                const __m128 v0 = _mm_loadu_ps (reinterpret_cast <const float*> (src + 2 * i));
+                const __m128 v1 = _mm_loadu_ps (reinterpret_cast <const float*> (src + 2 * i + 4));
+
+                _mm_stream_ps (reinterpret_cast <float*> (left + i),  _mm_shuffle_ps (v0, v1, _MM_SHUFFLE (2, 0, 2, 0)));
+                _mm_stream_ps (reinterpret_cast <float*> (right + i), _mm_shuffle_ps (v0, v1, _MM_SHUFFLE (3, 1, 3, 1)));
+            }
+
+            _mm_sfence();
+        }
+
+        for (; i + 4 <= numFrames; i += 4)
+        {
+            const __m128 v0 = _mm_loadu_ps (reinterpret_cast <const float*> (src + 2 * i));      // L0 R0 L1 R1
+            const __m128 v1 = _mm_loadu_ps (reinterpret_cast <const float*> (src + 2 * i + 4));  // L2 R2 L3 R3
+
+            _mm_storeu_ps (reinterpret_cast <float*> (left + i),  _mm_shuffle_ps (v0, v1, _MM_SHUFFLE (2, 0, 2, 0)));
+            _mm_storeu_ps (reinterpret_cast <float*> (right + i), _mm_shuffle_ps (v0, v1, _MM_SHUFFLE (3, 1, 3, 1)));
+        }
+
+        for (; i < numFrames; ++i)
+        {
+            left[i]  = src[2 * i];
+            right[i] = src[2 * i + 1];
+        }
+    }
+
+    /* Interleaving counterparts of the helpers above, used by the writer to
+       pack two planar int32 channels into the interleaved output format, four
+       frames per iteration.
+    */
+    static void interleaveStereo16 (const int* left, const int* right, void* destData, int numFrames) noexcept
+    {
+        short* dest = static_cast <short*> (destData);
+        int i = 0;
+
+        for (; i + 4 <= numFrames; i += 4)
+        {
+            const __m128i l = _mm_srai_epi32 (_mm_loadu_si128 (reinterpret_cast <const __m128i*> (left + i)), 16);
+            const __m128i r = _mm_srai_epi32 (_mm_loadu_si128 (reinterpret_cast <const __m128i*> (right + i)), 16);
+
+            _mm_storeu_si128 (reinterpret_cast <__m128i*> (dest + 2 * i),
+                              _mm_unpacklo_epi16 (_mm_packs_epi32 (l, l), _mm_packs_epi32 (r, r)));
+        }
+
+        for (; i < numFrames; ++i)
+        {
+            dest[2 * i]     = (short) (left[i] >> 16);
+            dest[2 * i + 1] = (short) (right[i] >> 16);
+        }
+    }
+
+    static void interleaveStereo32 (const int* left, const int* right, void* destData, int numFrames) noexcept
+    {
+        int* dest = static_cast <int*> (destData);
+        int i = 0;
+
+        for (; i + 4 <= numFrames; i += 4)
+        {
+            const __m128i l = _mm_loadu_si128 (reinterpret_cast <const __m128i*> (left + i));
+            const __m128i r = _mm_loadu_si128 (reinterpret_cast <const __m128i*> (right + i));
+
+            _mm_storeu_si128 (reinterpret_cast <__m128i*> (dest + 2 * i),     _mm_unpacklo_epi32 (l, r));
+            _mm_storeu_si128 (reinterpret_cast <__m128i*> (dest + 2 * i + 4), _mm_unpackhi_epi32 (l, r));
+        }
+
+        for (; i < numFrames; ++i)
+        {
+            dest[2 * i]     = left[i];
+            dest[2 * i + 1] = right[i];
+        }
+    }
+
+   #ifdef __SSSE3__
+    /* Expands packed little-endian 24-bit samples into int32s shifted up by 8
+       bits, using a PSHUFB gather to place each 3-byte sample into the top of
+       its destination lane. Each 16-byte load only consumes 12 bytes of input,
+       so the loops stop 4 bytes short of the end and finish off with the
+       scalar conversion.
+    */
+    static void deinterleaveStereo24 (const void* sourceData, int* left, int* right, int numFrames) noexcept
+    {
+        const char* src = static_cast <const char*> (sourceData);
+        const int totalBytes = numFrames * 6;
+        int i = 0;
+
+        const __m128i maskL = _mm_setr_epi8 (-1, 0, 1, 2,  -1, 6, 7, 8,   -1, -1, -1, -1,  -1, -1, -1, -1);
+        const __m128i maskR = _mm_setr_epi8 (-1, 3, 4, 5,  -1, 9, 10, 11, -1, -1, -1, -1,  -1, -1, -1, -1);
+
+        for (; 6 * i + 16 <= totalBytes; i += 2)
+        {
+            const __m128i v = _mm_loadu_si128 (reinterpret_cast <const __m128i*> (src + 6 * i));
+
+            _mm_storel_epi64 (reinterpret_cast <__m128i*> (left + i),  _mm_shuffle_epi8 (v, maskL));
+            _mm_storel_epi64 (reinterpret_cast <__m128i*> (right + i), _mm_shuffle_epi8 (v, maskR));
+        }
+
+        for (; i < numFrames; ++i)
+        {
+            left[i]  = ByteOrder::littleEndian24Bit (src + 6 * i)     << 8;
+            right[i] = ByteOrder::littleEndian24Bit (src + 6 * i + 3) << 8;
+        }
+    }
+
+    static void convertMono24 (const void* sourceData, int* dest, int numFrames) noexcept
+    {
+        const char* src = static_cast <const char*> (sourceData);
+        const int totalBytes = numFrames * 3;
+        int i = 0;
+
+        const __m128i mask = _mm_setr_epi8 (-1, 0, 1, 2,  -1, 3, 4, 5,  -1, 6, 7, 8,  -1, 9, 10, 11);
+
+        for (; 3 * i + 16 <= totalBytes; i += 4)
+        {
+            const __m128i v = _mm_loadu_si128 (reinterpret_cast <const __m128i*> (src + 3 * i));
+            _mm_storeu_si128 (reinterpret_cast <__m128i*> (dest + i), _mm_shuffle_epi8 (v, mask));
+        }
+
+        for (; i < numFrames; ++i)
+            dest[i] = ByteOrder::littleEndian24Bit (src + 3 * i) << 8;
+    }
+
+    /* Widens offset-binary 8-bit samples into the top byte of each int32 lane.
+       The usual -128 recentring is an XOR with 0x80 done on all 16 bytes at
+       once, before the shuffles spread them out.
+    */
+    static void deinterleaveStereo8 (const void* sourceData, int* left, int* right, int numFrames) noexcept
+    {
+        const char* src = static_cast <const char*> (sourceData);
+        int i = 0;
+
+        const __m128i offset = _mm_set1_epi8 ((char) 0x80);
+        const __m128i maskL0 = _mm_setr_epi8 (-1, -1, -1, 0,  -1, -1, -1, 2,   -1, -1, -1, 4,   -1, -1, -1, 6);
+        const __m128i maskL1 = _mm_setr_epi8 (-1, -1, -1, 8,  -1, -1, -1, 10,  -1, -1, -1, 12,  -1, -1, -1, 14);
+        const __m128i maskR0 = _mm_setr_epi8 (-1, -1, -1, 1,  -1, -1, -1, 3,   -1, -1, -1, 5,   -1, -1, -1, 7);
+        const __m128i maskR1 = _mm_setr_epi8 (-1, -1, -1, 9,  -1, -1, -1, 11,  -1, -1, -1, 13,  -1, -1, -1, 15);
+
+        for (; i + 8 <= numFrames; i += 8)
+        {
+            const __m128i v = _mm_xor_si128 (_mm_loadu_si128 (reinterpret_cast <const __m128i*> (src + 2 * i)), offset);
+
+            _mm_storeu_si128 (reinterpret_cast <__m128i*> (left + i),      _mm_shuffle_epi8 (v, maskL0));
+            _mm_storeu_si128 (reinterpret_cast <__m128i*> (left + i + 4),  _mm_shuffle_epi8 (v, maskL1));
+            _mm_storeu_si128 (reinterpret_cast <__m128i*> (right + i),     _mm_shuffle_epi8 (v, maskR0));
+            _mm_storeu_si128 (reinterpret_cast <__m128i*> (right + i + 4), _mm_shuffle_epi8 (v, maskR1));
+        }
+
+        for (; i < numFrames; ++i)
+        {
+            left[i]  = (((int) (uint8) src[2 * i])     ^ 0x80) << 24;
+            right[i] = (((int) (uint8) src[2 * i + 1]) ^ 0x80) << 24;
+        }
+    }
+
+    static void convertMono8 (const void* sourceData, int* dest, int numFrames) noexcept
+    {
+        const char* src = static_cast <const char*> (sourceData);
+        int i = 0;
+
+        const __m128i offset = _mm_set1_epi8 ((char) 0x80);
+        const __m128i mask0 = _mm_setr_epi8 (-1, -1, -1, 0,   -1, -1, -1, 1,   -1, -1, -1, 2,   -1, -1, -1, 3);
+        const __m128i mask1 = _mm_setr_epi8 (-1, -1, -1, 4,   -1, -1, -1, 5,   -1, -1, -1, 6,   -1, -1, -1, 7);
+        const __m128i mask2 = _mm_setr_epi8 (-1, -1, -1, 8,   -1, -1, -1, 9,   -1, -1, -1, 10,  -1, -1, -1, 11);
+        const __m128i mask3 = _mm_setr_epi8 (-1, -1, -1, 12,  -1, -1, -1, 13,  -1, -1, -1, 14,  -1, -1, -1, 15);
+
+        for (; i + 16 <= numFrames; i += 16)
+        {
+            const __m128i v = _mm_xor_si128 (_mm_loadu_si128 (reinterpret_cast <const __m128i*> (src + i)), offset);
+
+            _mm_storeu_si128 (reinterpret_cast <__m128i*> (dest + i),      _mm_shuffle_epi8 (v, mask0));
+            _mm_storeu_si128 (reinterpret_cast <__m128i*> (dest + i + 4),  _mm_shuffle_epi8 (v, mask1));
+            _mm_storeu_si128 (reinterpret_cast <__m128i*> (dest + i + 8),  _mm_shuffle_epi8 (v, mask2));
+            _mm_storeu_si128 (reinterpret_cast <__m128i*> (dest + i + 12), _mm_shuffle_epi8 (v, mask3));
+        }
+
+        for (; i < numFrames; ++i)
+            dest[i] = (((int) (uint8) src[i]) ^ 0x80) << 24;
+    }
+   #endif
+   #endif
+
+    //==============================================================================
+   #if JUCE_USE_ARM_NEON
+    /* NEON versions of the 16 and 32-bit stereo helpers above. vld2q splits the
+       interleaved frames as part of the load, so these need no shuffling at all,
+       and vshll widens and shifts the 16-bit samples in one step.
+    */
+    static void deinterleaveStereo16 (const void* sourceData, int* left, int* right, int numFrames) noexcept
+    {
+        const int16_t* src = static_cast <const int16_t*> (sourceData);
+        int i = 0;
+
+        for (; i + 8 <= numFrames; i += 8)
+        {
+            const int16x8x2_t v = vld2q_s16 (src + 2 * i);
+
+            vst1q_s32 (reinterpret_cast <int32_t*> (left + i),      vshll_n_s16 (vget_low_s16  (v.val[0]), 16));
+            vst1q_s32 (reinterpret_cast <int32_t*> (left + i + 4),  vshll_n_s16 (vget_high_s16 (v.val[0]), 16));
+            vst1q_s32 (reinterpret_cast <int32_t*> (right + i),     vshll_n_s16 (vget_low_s16  (v.val[1]), 16));
+            vst1q_s32 (reinterpret_cast <int32_t*> (right + i + 4), vshll_n_s16 (vget_high_s16 (v.val[1]), 16));
+        }
+
+        for (; i < numFrames; ++i)
+        {
+            left[i]  = ((int) src[2 * i])     << 16;
+            right[i] = ((int) src[2 * i + 1]) << 16;
+        }
+    }
+
+    static void deinterleaveStereo32 (const void* sourceData, int* left, int* right, int numFrames) noexcept
+    {
+        const int32_t* src = static_cast <const int32_t*> (sourceData);
+        int i = 0;
+
+        for (; i + 4 <= numFrames; i += 4)
+        {
+            const int32x4x2_t v = vld2q_s32 (src + 2 * i);
+
+            vst1q_s32 (reinterpret_cast <int32_t*> (left + i),  v.val[0]);
+            vst1q_s32 (reinterpret_cast <int32_t*> (right + i), v.val[1]);
+        }
+
+        for (; i < numFrames; ++i)
+        {
+            left[i]  = (int) src[2 * i];
+            right[i] = (int) src[2 * i + 1];
+        }
+    }
+   #endif
 }
 
 //==============================================================================
@@ -548,7 +963,8 @@ public:
           bwavChunkStart (0),
           bwavSize (0),
           dataLength (0),
-          isRF64 (false)
+          isRF64 (false),
+          triedToMapFile (false)
     {
         using namespace WavFileHelpers;
         uint64 len = 0;
@@ -557,6 +973,13 @@ public:
         int cueLabelIndex = 0;
         int cueRegionIndex = 0;
 
+        // The header scan does lots of tiny reads and seeks, so run it through a
+        // buffered stream rather than hitting the source directly. (This local
+        // deliberately shadows the member for the rest of the constructor - sample
+        // reading still uses the raw stream.)
+        BufferedInputStream bufferedHeader (*in, 8192);
+        InputStream* const input = &bufferedHeader;
+
         const int firstChunkType = input->readInt();
 
         if (firstChunkType == chunkName ("RF64"))
@@ -598,162 +1021,185 @@ public:
                 uint32 length = (uint32) input->readInt();
                 const int64 chunkEnd = input->getPosition() + length + (length & 1);
 
-                if (chunkType == chunkName ("fmt "))
-                {
-                    // read the format chunk
-                    const unsigned short format = (unsigned short) input->readShort();
-                    numChannels = (unsigned int) input->readShort();
-                    sampleRate = input->readInt();
-                    const int bytesPerSec = input->readInt();
-                    input->skipNextBytes (2);
-                    bitsPerSample = (unsigned int) (int) input->readShort();
-
-                    if (bitsPerSample > 64)
-                    {
-                        bytesPerFrame = bytesPerSec / (int) sampleRate;
-                        bitsPerSample = 8 * (unsigned int) bytesPerFrame / numChannels;
-                    }
-                    else
-                    {
-                        bytesPerFrame = numChannels * bitsPerSample / 8;
-                    }
+                bool stopScanning = false;
 
-                    if (format == 3)
-                    {
-                        usesFloatingPointData = true;
-                    }
-                    else if (format == 0xfffe /*WAVE_FORMAT_EXTENSIBLE*/)
+                switch (chunkType)
+                {
+                    case NamedChunk<'f','m','t',' '>::ID:
                     {
-                        if (length < 40) // too short
+                        // read the format chunk
+                        const unsigned short format = (unsigned short) input->readShort();
+                        numChannels = (unsigned int) input->readShort();
+                        sampleRate = input->readInt();
+                        const int bytesPerSec = input->readInt();
+                        input->skipNextBytes (2);
+                        bitsPerSample = (unsigned int) (int) input->readShort();
+
+                        if (bitsPerSample > 64)
                         {
-                            bytesPerFrame = 0;
+                            bytesPerFrame = bytesPerSec / (int) sampleRate;
+                            bitsPerSample = 8 * (unsigned int) bytesPerFrame / numChannels;
                         }
                         else
                         {
-                            input->skipNextBytes (4); // skip over size and bitsPerSample
-                            metadataValues.set ("ChannelMask", String (input->readInt()));
-
-                            ExtensibleWavSubFormat subFormat;
-                            subFormat.data1 = (uint32) input->readInt();
-                            subFormat.data2 = (uint16) input->readShort();
-                            subFormat.data3 = (uint16) input->readShort();
-                            input->read (subFormat.data4, sizeof (subFormat.data4));
-
-                            if (memcmp (&subFormat, &pcmFormat, sizeof (subFormat)) != 0
-                                 && memcmp (&subFormat, &IEEEFloatFormat, sizeof (subFormat)) != 0
-                                 && memcmp (&subFormat, &ambisonicFormat, sizeof (subFormat)) != 0)
+                            bytesPerFrame = numChannels * bitsPerSample / 8;
+                        }
+
+                        if (format == 3)
+                        {
+                            usesFloatingPointData = true;
+                        }
+                        else if (format == 0xfffe /*WAVE_FORMAT_EXTENSIBLE*/)
+                        {
+                            if (length < 40) // too short
+                            {
                                 bytesPerFrame = 0;
+                            }
+                            else
+                            {
+                                input->skipNextBytes (4); // skip over size and bitsPerSample
+                                metadataValues.set ("ChannelMask", String (input->readInt()));
+
+                                ExtensibleWavSubFormat subFormat;
+                                subFormat.data1 = (uint32) input->readInt();
+                                subFormat.data2 = (uint16) input->readShort();
+                                subFormat.data3 = (uint16) input->readShort();
+                                input->read (subFormat.data4, sizeof (subFormat.data4));
+
+                                if (memcmp (&subFormat, &pcmFormat, sizeof (subFormat)) != 0
+                                     && memcmp (&subFormat, &IEEEFloatFormat, sizeof (subFormat)) != 0
+                                     && memcmp (&subFormat, &ambisonicFormat, sizeof (subFormat)) != 0)
+                                    bytesPerFrame = 0;
+                            }
                         }
+                        else if (format != 1)
+                        {
+                            bytesPerFrame = 0;
+                        }
+
+                        break;
                     }
-                    else if (format != 1)
-                    {
-                        bytesPerFrame = 0;
-                    }
-                }
-                else if (chunkType == chunkName ("data"))
-                {
-                    if (! isRF64) // data size is expected to be -1, actual data size is in ds64 chunk
-                        dataLength = length;
 
-                    dataChunkStart = input->getPosition();
-                    lengthInSamples = (bytesPerFrame > 0) ? (dataLength / bytesPerFrame) : 0;
-                }
-                else if (chunkType == chunkName ("bext"))
-                {
-                    bwavChunkStart = input->getPosition();
-                    bwavSize = length;
+                    case NamedChunk<'d','a','t','a'>::ID:
+                        if (! isRF64) // data size is expected to be -1, actual data size is in ds64 chunk
+                            dataLength = length;
 
-                    HeapBlock <BWAVChunk> bwav;
-                    bwav.calloc (jmax ((size_t) length + 1, sizeof (BWAVChunk)), 1);
-                    input->read (bwav, (int) length);
-                    bwav->copyTo (metadataValues, (int) length);
-                }
-                else if (chunkType == chunkName ("smpl"))
-                {
-                    HeapBlock <SMPLChunk> smpl;
-                    smpl.calloc (jmax ((size_t) length + 1, sizeof (SMPLChunk)), 1);
-                    input->read (smpl, (int) length);
-                    smpl->copyTo (metadataValues, (int) length);
-                }
-                else if (chunkType == chunkName ("inst") || chunkType == chunkName ("INST")) // need to check which...
-                {
-                    HeapBlock <InstChunk> inst;
-                    inst.calloc (jmax ((size_t) length + 1, sizeof (InstChunk)), 1);
-                    input->read (inst, (int) length);
-                    inst->copyTo (metadataValues);
-                }
-                else if (chunkType == chunkName ("cue "))
-                {
-                    HeapBlock <CueChunk> cue;
-                    cue.calloc (jmax ((size_t) length + 1, sizeof (CueChunk)), 1);
-                    input->read (cue, (int) length);
-                    cue->copyTo (metadataValues, (int) length);
-                }
-                else if (chunkType == chunkName ("LIST"))
-                {
-                    if (input->readInt() == chunkName ("adtl"))
+                        dataChunkStart = input->getPosition();
+                        lengthInSamples = (bytesPerFrame > 0) ? (dataLength / bytesPerFrame) : 0;
+                        break;
+
+                    case NamedChunk<'b','e','x','t'>::ID:
                     {
-                        while (input->getPosition() < chunkEnd)
-                        {
-                            const int adtlChunkType = input->readInt();
-                            const uint32 adtlLength = (uint32) input->readInt();
-                            const int64 adtlChunkEnd = input->getPosition() + (adtlLength + (adtlLength & 1));
+                        bwavChunkStart = input->getPosition();
+                        bwavSize = length;
 
-                            if (adtlChunkType == chunkName ("labl") || adtlChunkType == chunkName ("note"))
-                            {
-                                String prefix;
+                        MetadataChunkBuffer bwav (*input, length, sizeof (BWAVChunk));
+                        bwav.get<BWAVChunk>()->copyTo (metadataValues, (int) length);
+                        break;
+                    }
 
-                                if (adtlChunkType == chunkName ("labl"))
-                                    prefix << "CueLabel" << cueLabelIndex++;
-                                else if (adtlChunkType == chunkName ("note"))
-                                    prefix << "CueNote" << cueNoteIndex++;
+                    case NamedChunk<'s','m','p','l'>::ID:
+                    {
+                        MetadataChunkBuffer smpl (*input, length, sizeof (SMPLChunk));
+                        smpl.get<SMPLChunk>()->copyTo (metadataValues, (int) length);
+                        break;
+                    }
 
-                                const uint32 identifier = (uint32) input->readInt();
-                                const int stringLength = (int) adtlLength - 4;
+                    case NamedChunk<'i','n','s','t'>::ID:
+                    case NamedChunk<'I','N','S','T'>::ID: // need to check which...
+                    {
+                        MetadataChunkBuffer inst (*input, length, sizeof (InstChunk));
+                        inst.get<InstChunk>()->copyTo (metadataValues);
+                        break;
+                    }
 
-                                MemoryBlock textBlock;
-                                input->readIntoMemoryBlock (textBlock, stringLength);
+                    case NamedChunk<'c','u','e',' '>::ID:
+                    {
+                        MetadataChunkBuffer cue (*input, length, sizeof (CueChunk));
+                        cue.get<CueChunk>()->copyTo (metadataValues, (int) length);
+                        break;
+                    }
 
-                                metadataValues.set (prefix + "Identifier", String (identifier));
-                                metadataValues.set (prefix + "Text", textBlock.toString());
-                            }
-                            else if (adtlChunkType == chunkName ("ltxt"))
+                    case NamedChunk<'L','I','S','T'>::ID:
+                        if (input->readInt() == chunkName ("adtl"))
+                        {
+                            while (input->getPosition() < chunkEnd)
                             {
-                                const String prefix ("CueRegion" + String (cueRegionIndex++));
-                                const uint32 identifier     = (uint32) input->readInt();
-                                const uint32 sampleLength   = (uint32) input->readInt();
-                                const uint32 purpose        = (uint32) input->readInt();
-                                const uint16 country        = (uint16) input->readInt();
-                                const uint16 language       = (uint16) input->readInt();
-                                const uint16 dialect        = (uint16) input->readInt();
-                                const uint16 codePage       = (uint16) input->readInt();
-                                const uint32 stringLength   = adtlLength - 20;
-
-                                MemoryBlock textBlock;
-                                input->readIntoMemoryBlock (textBlock, (int) stringLength);
-
-                                metadataValues.set (prefix + "Identifier",   String (identifier));
-                                metadataValues.set (prefix + "SampleLength", String (sampleLength));
-                                metadataValues.set (prefix + "Purpose",      String (purpose));
-                                metadataValues.set (prefix + "Country",      String (country));
-                                metadataValues.set (prefix + "Language",     String (language));
-                                metadataValues.set (prefix + "Dialect",      String (dialect));
-                                metadataValues.set (prefix + "CodePage",     String (codePage));
-                                metadataValues.set (prefix + "Text",         textBlock.toString());
+                                const int adtlChunkType = input->readInt();
+                                const uint32 adtlLength = (uint32) input->readInt();
+                                const int64 adtlChunkEnd = input->getPosition() + (adtlLength + (adtlLength & 1));
+
+                                switch (adtlChunkType)
+                                {
+                                    case NamedChunk<'l','a','b','l'>::ID:
+                                    case NamedChunk<'n','o','t','e'>::ID:
+                                    {
+                                        String prefix;
+
+                                        if (adtlChunkType == NamedChunk<'l','a','b','l'>::ID)
+                                            prefix << "CueLabel" << cueLabelIndex++;
+                                        else
+                                            prefix << "CueNote" << cueNoteIndex++;
+
+                                        const uint32 identifier = (uint32) input->readInt();
+                                        const int stringLength = (int) adtlLength - 4;
+
+                                        MemoryBlock textBlock;
+                                        input->readIntoMemoryBlock (textBlock, stringLength);
+
+                                        metadataValues.set (prefix + "Identifier", String (identifier));
+                                        metadataValues.set (prefix + "Text", textBlock.toString());
+                                        break;
+                                    }
+
+                                    case NamedChunk<'l','t','x','t'>::ID:
+                                    {
+                                        const String prefix ("CueRegion" + String (cueRegionIndex++));
+                                        const uint32 identifier     = (uint32) input->readInt();
+                                        const uint32 sampleLength   = (uint32) input->readInt();
+                                        const uint32 purpose        = (uint32) input->readInt();
+                                        const uint16 country        = (uint16) input->readInt();
+                                        const uint16 language       = (uint16) input->readInt();
+                                        const uint16 dialect        = (uint16) input->readInt();
+                                        const uint16 codePage       = (uint16) input->readInt();
+                                        const uint32 stringLength   = adtlLength - 20;
+
+                                        MemoryBlock textBlock;
+                                        input->readIntoMemoryBlock (textBlock, (int) stringLength);
+
+                                        metadataValues.set (prefix + "Identifier",   String (identifier));
+                                        metadataValues.set (prefix + "SampleLength", String (sampleLength));
+                                        metadataValues.set (prefix + "Purpose",      String (purpose));
+                                        metadataValues.set (prefix + "Country",      String (country));
+                                        metadataValues.set (prefix + "Language",     String (language));
+                                        metadataValues.set (prefix + "Dialect",      String (dialect));
+                                        metadataValues.set (prefix + "CodePage",     String (codePage));
+                                        metadataValues.set (prefix + "Text",         textBlock.toString());
+                                        break;
+                                    }
+
+                                    default: break;
+                                }
+
+                                input->setPosition (adtlChunkEnd);
                             }
-
-                            input->setPosition (adtlChunkEnd);
                         }
-                    }
+                        break;
+
+                    case NamedChunk<'a','c','i','d'>::ID:
+                        AcidChunk (*input, length).addToMetadata (metadataValues);
+                        break;
+
+                    default:
+                        // an unrecognised chunk with a bogus length would leave us
+                        // spinning on the same file position, so give up if we're
+                        // not going to advance
+                        stopScanning = chunkEnd <= input->getPosition();
+                        break;
                 }
-                else if (chunkType == chunkName ("acid"))
-                {
-                    AcidChunk (*input, length).addToMetadata (metadataValues);
-                }
-                else if (chunkEnd <= input->getPosition())
-                {
+
+                if (stopScanning)
                     break;
-                }
 
                 input->setPosition (chunkEnd);
             }
@@ -775,25 +1221,66 @@ public:
         if (numSamples <= 0)
             return true;
 
+        if (! triedToMapFile)
+        {
+            triedToMapFile = true;
+            mapFileIfWorthwhile();
+        }
+
+        if (directMap != nullptr)
+        {
+            const int64 byteStart = dataChunkStart + startSampleInFile * bytesPerFrame;
+            const int64 byteEnd   = byteStart + numSamples * (int64) bytesPerFrame;
+
+            if (byteEnd <= (int64) directMap->getSize())
+            {
+                // The mapped data is read-only, so on big-endian targets this uses
+                // the little-endian readers which swap each sample as it's converted.
+                copySampleData <AudioData::LittleEndian> (bitsPerSample, usesFloatingPointData,
+                                                          destSamples, startOffsetInDestBuffer, numDestChannels,
+                                                          addBytesToPointer (directMap->getData(), byteStart),
+                                                          (int) numChannels, numSamples);
+                return true;
+            }
+        }
+
         input->setPosition (dataChunkStart + startSampleInFile * bytesPerFrame);
 
+        // The buffer is allocated on first use, so that readers which are only
+        // opened to inspect the metadata never pay for it.
+        if (tempBuffer == nullptr)
+            tempBuffer.malloc (tempBufferSize);
+
         while (numSamples > 0)
         {
-            const int tempBufSize = 480 * 3 * 4; // (keep this a multiple of 3)
-            char tempBuffer [tempBufSize];
+            const int numThisTime = jmin (tempBufferSize / bytesPerFrame, numSamples);
+            const int bytesRead = jmax (0, input->read (tempBuffer, numThisTime * bytesPerFrame));
+            const int framesRead = bytesRead / bytesPerFrame;
 
-            const int numThisTime = jmin (tempBufSize / bytesPerFrame, numSamples);
-            const int bytesRead = input->read (tempBuffer, numThisTime * bytesPerFrame);
-
-            if (bytesRead < numThisTime * bytesPerFrame)
+            if (framesRead < numThisTime)
             {
-                jassert (bytesRead >= 0);
-                zeromem (tempBuffer + bytesRead, (size_t) (numThisTime * bytesPerFrame - bytesRead));
+                // A short read means we've hit the end of the stream - rather than
+                // zeroing the unread tail of the temp buffer and then converting
+                // it, just convert the frames we did get, and clear the missing
+                // part of the destination directly in a single pass.
+                for (int i = numDestChannels; --i >= 0;)
+                    if (destSamples[i] != nullptr)
+                        zeromem (destSamples[i] + startOffsetInDestBuffer + framesRead,
+                                 ((size_t) (numThisTime - framesRead)) * sizeof (int));
             }
 
-            copySampleData (bitsPerSample, usesFloatingPointData,
-                            destSamples, startOffsetInDestBuffer, numDestChannels,
-                            tempBuffer, (int) numChannels, numThisTime);
+           #if JUCE_BIG_ENDIAN
+            // Swap the whole block to native order in one pass, so that the
+            // conversion below can use the straight-through native readers.
+            if (bitsPerSample == 16 || bitsPerSample == 32)
+                WavFileHelpers::byteSwapBuffer (tempBuffer, framesRead * (int) numChannels,
+                                                (int) bitsPerSample / 8);
+           #endif
+
+            if (framesRead > 0)
+                copySampleData <AudioData::NativeEndian> (bitsPerSample, usesFloatingPointData,
+                                                          destSamples, startOffsetInDestBuffer, numDestChannels,
+                                                          tempBuffer, (int) numChannels, framesRead);
 
             startOffsetInDestBuffer += numThisTime;
             numSamples -= numThisTime;
@@ -802,29 +1289,134 @@ public:
         return true;
     }
 
+    /* WordEndianness describes the byte order of the 16 and 32-bit cases - callers
+       which have already swapped the source to native order pass NativeEndian,
+       those handing over raw file data pass LittleEndian. The 8 and 24-bit cases
+       always read the data in file order.
+    */
+    template <typename WordEndianness>
     static void copySampleData (unsigned int bitsPerSample, const bool usesFloatingPointData,
                                 int* const* destSamples, int startOffsetInDestBuffer, int numDestChannels,
                                 const void* sourceData, int numChannels, int numSamples) noexcept
     {
+       #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
+        // The channel layout is resolved once up-front, so each bit-depth case
+        // below just tests a single flag rather than re-deriving which of the
+        // vectorised stereo/mono paths applies.
+        const bool isStereoPair = numChannels == 2 && numDestChannels == 2
+                                    && destSamples[0] != nullptr && destSamples[1] != nullptr;
+
+        int* const left  = isStereoPair ? destSamples[0] + startOffsetInDestBuffer : nullptr;
+        int* const right = isStereoPair ? destSamples[1] + startOffsetInDestBuffer : nullptr;
+
+       #if JUCE_USE_SSE_INTRINSICS
+        const bool useStereoFastPath = isStereoPair && WavFileHelpers::isSSE2Available();
+       #else
+        const bool useStereoFastPath = isStereoPair; // (NEON needs no runtime check)
+       #endif
+       #endif
+
         switch (bitsPerSample)
         {
-            case 8:     ReadHelper<AudioData::Int32, AudioData::UInt8, AudioData::LittleEndian>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, numChannels, numSamples); break;
-            case 16:    ReadHelper<AudioData::Int32, AudioData::Int16, AudioData::LittleEndian>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, numChannels, numSamples); break;
-            case 24:    ReadHelper<AudioData::Int32, AudioData::Int24, AudioData::LittleEndian>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, numChannels, numSamples); break;
-            case 32:    if (usesFloatingPointData) ReadHelper<AudioData::Float32, AudioData::Float32, AudioData::LittleEndian>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, numChannels, numSamples);
-                        else                       ReadHelper<AudioData::Int32,   AudioData::Int32,   AudioData::LittleEndian>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, numChannels, numSamples); break;
-            default:    jassertfalse; break;
-        }
-    }
+            case 8:
+               #if JUCE_USE_SSE_INTRINSICS && defined (__SSSE3__)
+                if (isStereoPair)
+                {
+                    WavFileHelpers::deinterleaveStereo8 (sourceData, left, right, numSamples);
+                    break;
+                }
 
-    int64 bwavChunkStart, bwavSize;
-    int64 dataChunkStart, dataLength;
-    int bytesPerFrame;
-    bool isRF64;
+                if (numChannels == 1 && numDestChannels == 1 && destSamples[0] != nullptr)
+                {
+                    WavFileHelpers::convertMono8 (sourceData, destSamples[0] + startOffsetInDestBuffer, numSamples);
+                    break;
+                }
+               #endif
 
-private:
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WavAudioFormatReader)
-};
+                ReadHelper<AudioData::Int32, AudioData::UInt8, AudioData::LittleEndian>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, numChannels, numSamples);
+                break;
+            case 16:
+               #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
+                if (useStereoFastPath)
+                {
+                    WavFileHelpers::deinterleaveStereo16 (sourceData, left, right, numSamples);
+                    break;
+                }
+               #endif
+
+                ReadHelper<AudioData::Int32, AudioData::Int16, WordEndianness>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, numChannels, numSamples);
+                break;
+            case 24:
+               #if JUCE_USE_SSE_INTRINSICS && defined (__SSSE3__)
+                if (isStereoPair)
+                {
+                    WavFileHelpers::deinterleaveStereo24 (sourceData, left, right, numSamples);
+                    break;
+                }
+
+                if (numChannels == 1 && numDestChannels == 1 && destSamples[0] != nullptr)
+                {
+                    WavFileHelpers::convertMono24 (sourceData, destSamples[0] + startOffsetInDestBuffer, numSamples);
+                    break;
+                }
+               #endif
+
+                ReadHelper<AudioData::Int32, AudioData::Int24, AudioData::LittleEndian>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, numChannels, numSamples);
+                break;
+            case 32:
+               #if JUCE_USE_SSE_INTRINSICS || JUCE_USE_ARM_NEON
+                if (useStereoFastPath)
+                {
+                    WavFileHelpers::deinterleaveStereo32 (sourceData, left, right, numSamples);
+                    break;
+                }
+               #endif
+
+                if (usesFloatingPointData) ReadHelper<AudioData::Float32, AudioData::Float32, WordEndianness>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, numChannels, numSamples);
+                else                       ReadHelper<AudioData::Int32,   AudioData::Int32,   WordEndianness>::read (destSamples, startOffsetInDestBuffer, numDestChannels, sourceData, numChannels, numSamples);
+                break;
+            default:    jassertfalse; break;
+        }
+    }
+
+    int64 bwavChunkStart, bwavSize;
+    int64 dataChunkStart, dataLength;
+    int bytesPerFrame;
+    bool isRF64;
+
+private:
+    // A large buffer keeps the number of read() calls down when pulling big
+    // sequential blocks. (Must be a multiple of 3, so that 24-bit frames pack
+    // into it exactly.)
+    enum { tempBufferSize = 65520 };
+    HeapBlock<char> tempBuffer;
+
+    ScopedPointer<MemoryMappedFile> directMap;
+    bool triedToMapFile;
+
+    /* For large files being read from disk, mapping the whole file lets
+       readSamples convert straight out of the page cache, rather than copying
+       each block into tempBuffer first. Small files aren't worth the cost of
+       setting up the mapping.
+    */
+    void mapFileIfWorthwhile()
+    {
+        if (FileInputStream* const fin = dynamic_cast <FileInputStream*> (input))
+        {
+            const File file (fin->getFile());
+
+            if (file.getSize() >= 1024 * 1024)
+            {
+                directMap = new MemoryMappedFile (file, MemoryMappedFile::readOnly);
+
+                if (directMap->getData() == nullptr)
+                    directMap = nullptr;
+            }
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WavAudioFormatReader)
+};
 
 //==============================================================================
 class WavAudioFormatWriter  : public AudioFormatWriter
@@ -854,6 +1446,13 @@ public:
             ListChunk::create (listChunk, metadataValues);
         }
 
+        // Batch exports create many short-lived writers, so rather than letting each
+        // one grow a fresh conversion buffer, the last writer's block is recycled.
+        {
+            const SpinLock::ScopedLockType sl (recycledTempBlockLock);
+            tempBlock.swapWith (recycledTempBlock);
+        }
+
         headerPosition = out->getPosition();
         writeHeader();
     }
@@ -867,6 +1466,11 @@ public:
         }
 
         writeHeader();
+
+        {
+            const SpinLock::ScopedLockType sl (recycledTempBlockLock);
+            tempBlock.swapWith (recycledTempBlock);
+        }
     }
 
     //==============================================================================
@@ -883,9 +1487,33 @@ public:
         switch (bitsPerSample)
         {
             case 8:     WriteHelper<AudioData::UInt8, AudioData::Int32, AudioData::LittleEndian>::write (tempBlock.getData(), (int) numChannels, data, numSamples); break;
-            case 16:    WriteHelper<AudioData::Int16, AudioData::Int32, AudioData::LittleEndian>::write (tempBlock.getData(), (int) numChannels, data, numSamples); break;
+
+            case 16:
+               #if JUCE_USE_SSE_INTRINSICS
+                if (numChannels == 2 && data[1] != nullptr && WavFileHelpers::isSSE2Available())
+                {
+                    WavFileHelpers::interleaveStereo16 (data[0], data[1], tempBlock.getData(), numSamples);
+                    break;
+                }
+               #endif
+
+                WriteHelper<AudioData::Int16, AudioData::Int32, AudioData::LittleEndian>::write (tempBlock.getData(), (int) numChannels, data, numSamples);
+                break;
+
             case 24:    WriteHelper<AudioData::Int24, AudioData::Int32, AudioData::LittleEndian>::write (tempBlock.getData(), (int) numChannels, data, numSamples); break;
-            case 32:    WriteHelper<AudioData::Int32, AudioData::Int32, AudioData::LittleEndian>::write (tempBlock.getData(), (int) numChannels, data, numSamples); break;
+
+            case 32:
+               #if JUCE_USE_SSE_INTRINSICS
+                if (numChannels == 2 && data[1] != nullptr && WavFileHelpers::isSSE2Available())
+                {
+                    WavFileHelpers::interleaveStereo32 (data[0], data[1], tempBlock.getData(), numSamples);
+                    break;
+                }
+               #endif
+
+                WriteHelper<AudioData::Int32, AudioData::Int32, AudioData::LittleEndian>::write (tempBlock.getData(), (int) numChannels, data, numSamples);
+                break;
+
             default:    jassertfalse; break;
         }
 
@@ -907,12 +1535,56 @@ public:
         }
     }
 
+    /* Streams raw sample data straight through to the output, for use when the
+       source bytes are already in exactly this writer's format - e.g. when
+       copying a file to change its metadata. The frames are bookkept just as
+       if they'd been passed through write().
+    */
+    bool writeRawSampleData (InputStream& source, int64 numBytes)
+    {
+        if (writeFailed)
+            return false;
+
+        const uint32 bytesPerFrame = numChannels * bitsPerSample / 8;
+        const size_t blockSize = 65536;
+        tempBlock.ensureSize (blockSize, false);
+
+        uint64 totalCopied = 0;
+
+        while (numBytes > 0)
+        {
+            const int numRead = source.read (tempBlock.getData(),
+                                             (int) jmin ((int64) blockSize, numBytes));
+
+            if (numRead <= 0)
+                break;
+
+            if (! output->write (tempBlock.getData(), (size_t) numRead))
+            {
+                writeHeader();
+                writeFailed = true;
+                return false;
+            }
+
+            totalCopied += (uint64) numRead;
+            numBytes -= numRead;
+        }
+
+        bytesWritten += totalCopied;
+        lengthInSamples += totalCopied / bytesPerFrame;
+
+        return numBytes == 0;
+    }
+
 private:
     MemoryBlock tempBlock, bwavChunk, smplChunk, instChunk, cueChunk, listChunk;
     uint64 lengthInSamples, bytesWritten;
     int64 headerPosition;
     bool writeFailed;
 
+    static SpinLock recycledTempBlockLock;
+    static MemoryBlock recycledTempBlock;
+
     static int getChannelMask (const int numChannels) noexcept
     {
         switch (numChannels)
@@ -939,6 +1611,10 @@ private:
         // to be able to seek back to write the header
         jassert (seekedOk);
 
+        // The header is assembled in memory and emitted with a single write,
+        // rather than as a long run of small stream writes.
+        MemoryOutputStream header (256);
+
         const size_t bytesPerFrame = numChannels * bitsPerSample / 8;
         uint64 audioDataSize = bytesPerFrame * lengthInSamples;
 
@@ -956,98 +1632,100 @@ private:
 
         riffChunkSize += (riffChunkSize & 1);
 
-        output->writeInt (chunkName (isRF64 ? "RF64" : "RIFF"));
-        output->writeInt (isRF64 ? -1 : (int) riffChunkSize);
-        output->writeInt (chunkName ("WAVE"));
+        header.writeInt (chunkName (isRF64 ? "RF64" : "RIFF"));
+        header.writeInt (isRF64 ? -1 : (int) riffChunkSize);
+        header.writeInt (chunkName ("WAVE"));
 
         if (! isRF64)
         {
-            output->writeInt (chunkName ("JUNK"));
-            output->writeInt (28 + (isWaveFmtEx? 0 : 24));
-            output->writeRepeatedByte (0, 28 /* ds64 */ + (isWaveFmtEx? 0 : 24));
+            header.writeInt (chunkName ("JUNK"));
+            header.writeInt (28 + (isWaveFmtEx? 0 : 24));
+            header.writeRepeatedByte (0, 28 /* ds64 */ + (isWaveFmtEx? 0 : 24));
         }
         else
         {
             // write ds64 chunk
-            output->writeInt (chunkName ("ds64"));
-            output->writeInt (28);  // chunk size for uncompressed data (no table)
-            output->writeInt64 (riffChunkSize);
-            output->writeInt64 ((int64) audioDataSize);
-            output->writeRepeatedByte (0, 12);
+            header.writeInt (chunkName ("ds64"));
+            header.writeInt (28);  // chunk size for uncompressed data (no table)
+            header.writeInt64 (riffChunkSize);
+            header.writeInt64 ((int64) audioDataSize);
+            header.writeRepeatedByte (0, 12);
         }
 
-        output->writeInt (chunkName ("fmt "));
+        header.writeInt (chunkName ("fmt "));
 
         if (isWaveFmtEx)
         {
-            output->writeInt (40); // chunk size
-            output->writeShort ((short) (uint16) 0xfffe); // WAVE_FORMAT_EXTENSIBLE
+            header.writeInt (40); // chunk size
+            header.writeShort ((short) (uint16) 0xfffe); // WAVE_FORMAT_EXTENSIBLE
         }
         else
         {
-            output->writeInt (16); // chunk size
-            output->writeShort (bitsPerSample < 32 ? (short) 1 /*WAVE_FORMAT_PCM*/
+            header.writeInt (16); // chunk size
+            header.writeShort (bitsPerSample < 32 ? (short) 1 /*WAVE_FORMAT_PCM*/
                                                    : (short) 3 /*WAVE_FORMAT_IEEE_FLOAT*/);
         }
 
-        output->writeShort ((short) numChannels);
-        output->writeInt ((int) sampleRate);
-        output->writeInt ((int) (bytesPerFrame * sampleRate)); // nAvgBytesPerSec
-        output->writeShort ((short) bytesPerFrame); // nBlockAlign
-        output->writeShort ((short) bitsPerSample); // wBitsPerSample
+        header.writeShort ((short) numChannels);
+        header.writeInt ((int) sampleRate);
+        header.writeInt ((int) (bytesPerFrame * sampleRate)); // nAvgBytesPerSec
+        header.writeShort ((short) bytesPerFrame); // nBlockAlign
+        header.writeShort ((short) bitsPerSample); // wBitsPerSample
 
         if (isWaveFmtEx)
         {
-            output->writeShort (22); // cbSize (size of  the extension)
-            output->writeShort ((short) bitsPerSample); // wValidBitsPerSample
-            output->writeInt (getChannelMask ((int) numChannels));
+            header.writeShort (22); // cbSize (size of  the extension)
+            header.writeShort ((short) bitsPerSample); // wValidBitsPerSample
+            header.writeInt (getChannelMask ((int) numChannels));
 
             const ExtensibleWavSubFormat& subFormat = bitsPerSample < 32 ? pcmFormat : IEEEFloatFormat;
 
-            output->writeInt ((int) subFormat.data1);
-            output->writeShort ((short) subFormat.data2);
-            output->writeShort ((short) subFormat.data3);
-            output->write (subFormat.data4, sizeof (subFormat.data4));
+            header.writeInt ((int) subFormat.data1);
+            header.writeShort ((short) subFormat.data2);
+            header.writeShort ((short) subFormat.data3);
+            header.write (subFormat.data4, sizeof (subFormat.data4));
         }
 
         if (bwavChunk.getSize() > 0)
         {
-            output->writeInt (chunkName ("bext"));
-            output->writeInt ((int) bwavChunk.getSize());
-            *output << bwavChunk;
+            header.writeInt (chunkName ("bext"));
+            header.writeInt ((int) bwavChunk.getSize());
+            header << bwavChunk;
         }
 
         if (smplChunk.getSize() > 0)
         {
-            output->writeInt (chunkName ("smpl"));
-            output->writeInt ((int) smplChunk.getSize());
-            *output << smplChunk;
+            header.writeInt (chunkName ("smpl"));
+            header.writeInt ((int) smplChunk.getSize());
+            header << smplChunk;
         }
 
         if (instChunk.getSize() > 0)
         {
-            output->writeInt (chunkName ("inst"));
-            output->writeInt (7);
-            *output << instChunk;
+            header.writeInt (chunkName ("inst"));
+            header.writeInt (7);
+            header << instChunk;
         }
 
         if (cueChunk.getSize() > 0)
         {
-            output->writeInt (chunkName ("cue "));
-            output->writeInt ((int) cueChunk.getSize());
-            *output << cueChunk;
+            header.writeInt (chunkName ("cue "));
+            header.writeInt ((int) cueChunk.getSize());
+            header << cueChunk;
         }
 
         if (listChunk.getSize() > 0)
         {
-            output->writeInt (chunkName ("LIST"));
-            output->writeInt ((int) listChunk.getSize() + 4);
-            output->writeInt (chunkName ("adtl"));
-            *output << listChunk;
+            header.writeInt (chunkName ("LIST"));
+            header.writeInt ((int) listChunk.getSize() + 4);
+            header.writeInt (chunkName ("adtl"));
+            header << listChunk;
         }
 
-        output->writeInt (chunkName ("data"));
-        output->writeInt (isRF64 ? -1 : (int) (lengthInSamples * bytesPerFrame));
+        header.writeInt (chunkName ("data"));
+        header.writeInt (isRF64 ? -1 : (int) (lengthInSamples * bytesPerFrame));
+
+        output->write (header.getData(), header.getDataSize());
 
         usesFloatingPointData = (bitsPerSample == 32);
     }
@@ -1055,6 +1733,9 @@ private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WavAudioFormatWriter)
 };
 
+SpinLock WavAudioFormatWriter::recycledTempBlockLock;
+MemoryBlock WavAudioFormatWriter::recycledTempBlock;
+
 //==============================================================================
 class MemoryMappedWavReader   : public MemoryMappedAudioFormatReader
 {
@@ -1077,9 +1758,11 @@ public:
             return false;
         }
 
-        WavAudioFormatReader::copySampleData (bitsPerSample, usesFloatingPointData,
-                                              destSamples, startOffsetInDestBuffer, numDestChannels,
-                                              sampleToPointer (startSampleInFile), (int) numChannels, numSamples);
+        // The mapped data is read-only, so it can't be pre-swapped - the
+        // little-endian readers swap each sample as it's converted.
+        WavAudioFormatReader::copySampleData <AudioData::LittleEndian> (bitsPerSample, usesFloatingPointData,
+                                                                        destSamples, startOffsetInDestBuffer, numDestChannels,
+                                                                        sampleToPointer (startSampleInFile), (int) numChannels, numSamples);
         return true;
     }
 
@@ -1186,7 +1869,9 @@ AudioFormatWriter* WavAudioFormat::createWriterFor (OutputStream* out, double sa
                                                     unsigned int numChannels, int bitsPerSample,
                                                     const StringPairArray& metadataValues, int /*qualityOptionIndex*/)
 {
-    if (getPossibleBitDepths().contains (bitsPerSample))
+    // The set of legal bit depths is a compile-time constant, so check it
+    // directly rather than building an Array just to search it.
+    if (bitsPerSample == 8 || bitsPerSample == 16 || bitsPerSample == 24 || bitsPerSample == 32)
         return new WavAudioFormatWriter (out, sampleRate, (unsigned int) numChannels,
                                          (unsigned int) bitsPerSample, metadataValues);
 
@@ -1195,6 +1880,224 @@ AudioFormatWriter* WavAudioFormat::createWriterFor (OutputStream* out, double sa
 
 namespace WavFileHelpers
 {
+    /* Scans just the top-level RIFF chunk directory for a 'bext' chunk, reporting
+       its data position and size. This is all that a metadata update needs, so it
+       avoids paying for a full header parse and the string allocations that
+       come with it. Returns false if the stream isn't a WAV or has no bext chunk.
+    */
+    static bool findBwavChunk (InputStream& input, int64& chunkPos, int64& chunkSize, bool& fileIsRF64)
+    {
+        uint64 end = 0;
+        int64 rf64DataLength = 0;
+        fileIsRF64 = false;
+
+        const int firstChunkType = input.readInt();
+
+        if (firstChunkType == chunkName ("RF64"))
+        {
+            input.skipNextBytes (4); // size is -1 for RF64
+            fileIsRF64 = true;
+        }
+        else if (firstChunkType == chunkName ("RIFF"))
+        {
+            const uint64 len = (uint64) (uint32) input.readInt();
+            end = len + (uint64) input.getPosition();
+        }
+        else
+        {
+            return false;
+        }
+
+        const int64 startOfRIFFChunk = input.getPosition();
+
+        if (input.readInt() != chunkName ("WAVE"))
+            return false;
+
+        if (fileIsRF64)
+        {
+            if (input.readInt() != chunkName ("ds64"))
+                return false;
+
+            const uint32 length = (uint32) input.readInt();
+
+            if (length < 28)
+                return false;
+
+            const int64 chunkEnd = input.getPosition() + length + (length & 1);
+            end = (uint64) input.readInt64() + (uint64) startOfRIFFChunk;
+            rf64DataLength = input.readInt64();
+            input.setPosition (chunkEnd);
+        }
+
+        while ((uint64) input.getPosition() < end && ! input.isExhausted())
+        {
+            const int chunkType = input.readInt();
+            uint32 length = (uint32) input.readInt();
+            int64 chunkEnd = input.getPosition() + length + (length & 1);
+
+            if (chunkType == NamedChunk<'b','e','x','t'>::ID)
+            {
+                chunkPos = input.getPosition();
+                chunkSize = length;
+                return true;
+            }
+
+            // in an RF64 file the data chunk's real length lives in the ds64 chunk
+            if (fileIsRF64 && chunkType == NamedChunk<'d','a','t','a'>::ID && length == 0xffffffff)
+                chunkEnd = input.getPosition() + rf64DataLength + (rf64DataLength & 1);
+
+            if (chunkEnd <= input.getPosition())
+                break;
+
+            input.setPosition (chunkEnd);
+        }
+
+        return false;
+    }
+
+    /* Batch-tagging tools tend to stamp identical metadata onto many files in
+       a row, so the last serialised bext chunk is kept and handed back whenever
+       the values match, rather than re-running the string formatting for every
+       file.
+    */
+    static MemoryBlock createCachedBWAVChunk (const StringPairArray& values)
+    {
+        static SpinLock cacheLock;
+        static bool cacheValid = false;
+        static StringPairArray cachedValues;
+        static MemoryBlock cachedChunk;
+
+        const SpinLock::ScopedLockType sl (cacheLock);
+
+        if (! (cacheValid && cachedValues == values))
+        {
+            cachedChunk = BWAVChunk::createFrom (values);
+            cachedValues = values;
+            cacheValid = true;
+        }
+
+        return cachedChunk;
+    }
+
+    /* Moves the [sourcePos .. sourcePos + numBytes) region of a file to destPos,
+       copying in large blocks - backwards when the destination is higher, so
+       that the overlapping region isn't trampled mid-copy.
+    */
+    static bool shiftFileContents (FileInputStream& in, FileOutputStream& out,
+                                   const int64 sourcePos, const int64 destPos,
+                                   const int64 numBytes, bool& fileWasModified)
+    {
+        const int64 blockSize = 1024 * 1024;
+        HeapBlock<char> buffer ((size_t) jmin (blockSize, numBytes));
+
+        if (destPos > sourcePos)
+        {
+            int64 remaining = numBytes;
+
+            while (remaining > 0)
+            {
+                const int n = (int) jmin (blockSize, remaining);
+                remaining -= n;
+
+                in.setPosition (sourcePos + remaining);
+
+                if (in.read (buffer, n) != n)
+                    return false;
+
+                out.setPosition (destPos + remaining);
+                fileWasModified = true;
+
+                if (! out.write (buffer, (size_t) n))
+                    return false;
+            }
+        }
+        else
+        {
+            int64 done = 0;
+
+            while (done < numBytes)
+            {
+                const int n = (int) jmin (blockSize, numBytes - done);
+
+                in.setPosition (sourcePos + done);
+
+                if (in.read (buffer, n) != n)
+                    return false;
+
+                out.setPosition (destPos + done);
+                fileWasModified = true;
+
+                if (! out.write (buffer, (size_t) n))
+                    return false;
+
+                done += n;
+            }
+        }
+
+        return true;
+    }
+
+    enum InPlacePatchResult
+    {
+        patchSucceeded,
+        patchNotPossible,       /**< Rejected before anything was written - the file is untouched. */
+        patchFailedAfterWriting /**< A write failed part-way through, so the file may be corrupt. */
+    };
+
+    /* Swaps the bext chunk of a plain RIFF file for one of a different size by
+       shifting everything after it and patching the chunk and RIFF size fields,
+       rather than re-encoding the whole file. (Not usable for RF64, where the
+       sizes live in the ds64 chunk instead.)
+
+       Unlike the temp-file rewrite, this mutates the target directly, so callers
+       must treat patchFailedAfterWriting as fatal - once part of the tail has
+       been moved, the samples no longer match the headers, and rewriting the
+       file from a reader at that point would just preserve the damage.
+    */
+    static InPlacePatchResult patchWavMetadataInPlace (const File& file, const int64 bwavPos,
+                                                       const int64 oldBwavSize, const MemoryBlock& newChunk)
+    {
+        const int64 oldFileSize = file.getSize();
+        const int64 oldChunkEnd = bwavPos + oldBwavSize + (oldBwavSize & 1);
+        const int64 newSize     = (int64) newChunk.getSize();  // (already padded to an even length)
+        const int64 newChunkEnd = bwavPos + newSize;
+        const int64 tailLength  = oldFileSize - oldChunkEnd;
+
+        if (tailLength < 0 || bwavPos < 8)
+            return patchNotPossible;
+
+        FileInputStream in (file);
+        FileOutputStream out (file);
+
+        if (in.failedToOpen() || out.failedToOpen())
+            return patchNotPossible;
+
+        bool fileWasModified = false;
+
+        if (! shiftFileContents (in, out, oldChunkEnd, newChunkEnd, tailLength, fileWasModified))
+            return fileWasModified ? patchFailedAfterWriting : patchNotPossible;
+
+        bool ok = out.setPosition (bwavPos - 4)
+                    && out.writeInt ((int) newSize)
+                    && out.write (newChunk.getData(), newChunk.getSize());
+
+        // ..and the outer RIFF size has to reflect the change too
+        ok = ok && out.setPosition (4)
+                && out.writeInt ((int) (oldFileSize + (newChunkEnd - oldChunkEnd) - 8));
+
+        if (ok && newChunkEnd < oldChunkEnd)
+            ok = out.setPosition (oldFileSize + (newChunkEnd - oldChunkEnd))
+                  && out.truncate().wasOk();
+
+        if (ok)
+        {
+            out.flush();
+            ok = out.getStatus().wasOk();
+        }
+
+        return ok ? patchSucceeded : patchFailedAfterWriting;
+    }
+
     static bool slowCopyWavFileWithNewMetadata (const File& file, const StringPairArray& metadata)
     {
         TemporaryFile tempFile (file);
@@ -1204,9 +2107,11 @@ namespace WavFileHelpers
 
         if (reader != nullptr)
         {
-            ScopedPointer <OutputStream> outStream (tempFile.getFile().createOutputStream());
+            // A big output buffer keeps the copy running in long sequential
+            // writes, instead of pushing each converted block to the OS.
+            ScopedPointer <FileOutputStream> outStream (new FileOutputStream (tempFile.getFile(), 1 << 20));
 
-            if (outStream != nullptr)
+            if (! outStream->failedToOpen())
             {
                 ScopedPointer <AudioFormatWriter> writer (wav.createWriterFor (outStream, reader->sampleRate,
                                                                                reader->numChannels, (int) reader->bitsPerSample,
@@ -1216,7 +2121,24 @@ namespace WavFileHelpers
                 {
                     outStream.release();
 
-                    bool ok = writer->writeFromAudioReader (*reader, 0, -1);
+                    bool ok;
+
+                    WavAudioFormatReader* const wavReader = static_cast <WavAudioFormatReader*> (static_cast <AudioFormatReader*> (reader));
+                    WavAudioFormatWriter* const wavWriter = static_cast <WavAudioFormatWriter*> (static_cast <AudioFormatWriter*> (writer));
+
+                    if (wavReader->usesFloatingPointData == wavWriter->isFloatingPoint())
+                    {
+                        // the sample format is unchanged, so the audio bytes can be
+                        // streamed across verbatim rather than being decoded and
+                        // re-encoded
+                        wavReader->input->setPosition (wavReader->dataChunkStart);
+                        ok = wavWriter->writeRawSampleData (*wavReader->input, wavReader->dataLength);
+                    }
+                    else
+                    {
+                        ok = writer->writeFromAudioReader (*reader, 0, -1);
+                    }
+
                     writer = nullptr;
                     reader = nullptr;
 
@@ -1232,40 +2154,436 @@ namespace WavFileHelpers
 bool WavAudioFormat::replaceMetadataInFile (const File& wavFile, const StringPairArray& newMetadata)
 {
     using namespace WavFileHelpers;
-    ScopedPointer <WavAudioFormatReader> reader (static_cast <WavAudioFormatReader*> (createReaderFor (wavFile.createInputStream(), true)));
 
-    if (reader != nullptr)
+    int64 bwavPos = 0, bwavSize = 0;
+    bool fileIsRF64 = false;
+
     {
-        const int64 bwavPos  = reader->bwavChunkStart;
-        const int64 bwavSize = reader->bwavSize;
-        reader = nullptr;
+        // Only the position and size of the existing bext chunk are needed here,
+        // so scan the top-level chunk directory for it instead of constructing a
+        // reader and fully parsing the header.
+        ScopedPointer <FileInputStream> in (wavFile.createInputStream());
 
-        if (bwavSize > 0)
+        if (in == nullptr || ! findBwavChunk (*in, bwavPos, bwavSize, fileIsRF64))
+            bwavSize = 0;
+    }
+
+    if (bwavSize > 0)
+    {
+        MemoryBlock chunk (createCachedBWAVChunk (newMetadata));
+
+        if (chunk.getSize() <= (size_t) bwavSize)
         {
-            MemoryBlock chunk (BWAVChunk::createFrom (newMetadata));
+            // the new one will fit in the space available, so write it directly..
+            const int64 oldSize = wavFile.getSize();
 
-            if (chunk.getSize() <= (size_t) bwavSize)
             {
-                // the new one will fit in the space available, so write it directly..
-                const int64 oldSize = wavFile.getSize();
+                FileOutputStream out (wavFile);
 
+                if (! out.failedToOpen())
                 {
-                    FileOutputStream out (wavFile);
+                    out.setPosition (bwavPos);
+                    out << chunk;
 
-                    if (! out.failedToOpen())
-                    {
-                        out.setPosition (bwavPos);
-                        out << chunk;
-                        out.setPosition (oldSize);
-                    }
+                    // pad out just the difference, so that no stale bytes of
+                    // the old chunk are left behind the new one
+                    if (chunk.getSize() < (size_t) bwavSize)
+                        out.writeRepeatedByte (0, (size_t) bwavSize - chunk.getSize());
+
+                    out.setPosition (oldSize);
                 }
+            }
 
-                jassert (wavFile.getSize() == oldSize);
+            jassert (wavFile.getSize() == oldSize);
+
+            return true;
+        }
+
+        // The new chunk is bigger than the old one, but for a plain RIFF
+        // file the chunk can still be resized in place by shifting whatever
+        // follows it, which only costs the tail of the file rather than a
+        // full decode and re-encode.
+        if (! fileIsRF64)
+        {
+            const InPlacePatchResult result = patchWavMetadataInPlace (wavFile, bwavPos, bwavSize, chunk);
 
+            if (result == patchSucceeded)
                 return true;
-            }
+
+            // If a write failed once the tail had started moving, the samples
+            // no longer line up with the headers, so falling back to a decode
+            // and re-encode here would silently bake the corruption into the
+            // replacement file - report the failure instead.
+            if (result == patchFailedAfterWriting)
+                return false;
         }
     }
 
     return slowCopyWavFileWithNewMetadata (wavFile, newMetadata);
 }
+
+
+//==============================================================================
+#if JUCE_UNIT_TESTS
+
+class WavAudioFormatTests  : public UnitTest
+{
+public:
+    WavAudioFormatTests() : UnitTest ("WAV file format") {}
+
+    //==============================================================================
+    // Decodes one sample of raw little-endian file data the way the scalar
+    // ReadHelper paths do, to give a reference that the vectorised converters
+    // must match bit-for-bit.
+    static int decodeSample (const uint8* const frame, const int bitsPerSample) noexcept
+    {
+        switch (bitsPerSample)
+        {
+            case 8:   return (int) ((uint32) (frame[0] ^ 0x80) << 24);
+            case 16:  return ((int) (int16) ByteOrder::littleEndianShort (frame)) << 16;
+            case 24:  return ByteOrder::littleEndian24Bit ((const char*) frame) << 8;
+            case 32:  return (int) ByteOrder::littleEndianInt (frame);
+            default:  jassertfalse; return 0;
+        }
+    }
+
+    void checkReadPattern (AudioFormatReader& reader, const HeapBlock<int>& expected,
+                           const int numChannels, const int numSamples,
+                           const int blockSize, const int destOffset, const int pointerOffset)
+    {
+        // round the channel stride to a whole number of 16-byte groups, so that
+        // offsetting every channel pointer equally leaves them misaligned by the
+        // same amount - the case the deinterleavers handle by peeling
+        const int stride = (numSamples + destOffset + pointerOffset + 7) & ~3;
+        HeapBlock<int> buffer ((size_t) (numChannels * stride), true);
+        int* dest [4] = { nullptr, nullptr, nullptr, nullptr };
+
+        for (int c = 0; c < numChannels; ++c)
+            dest[c] = buffer + (c * stride + pointerOffset);
+
+        for (int start = 0; start < numSamples;)
+        {
+            const int num = jmin (blockSize, numSamples - start);
+            reader.readSamples (dest, numChannels, destOffset + start, start, num);
+            start += num;
+        }
+
+        bool matchesReference = true;
+
+        for (int c = 0; c < numChannels; ++c)
+            for (int i = 0; i < numSamples; ++i)
+                matchesReference = matchesReference
+                                    && dest[c][destOffset + i] == expected [c * numSamples + i];
+
+        expect (matchesReference);
+    }
+
+    void checkAgainstReference (AudioFormatReader& reader, const HeapBlock<int>& expected,
+                                const int numChannels, const int numSamples)
+    {
+        // Whole-file reads into aligned and then misaligned buffers (for a
+        // memory-mapped reader with enough frames these are the conversions
+        // that use the streaming stores, with and without alignment peeling),
+        // then odd block sizes with misaligned destinations and offsets.
+        checkReadPattern (reader, expected, numChannels, numSamples, numSamples, 0, 0);
+        checkReadPattern (reader, expected, numChannels, numSamples, numSamples, 0, 1);
+        checkReadPattern (reader, expected, numChannels, numSamples, 7, 0, 1);
+        checkReadPattern (reader, expected, numChannels, numSamples, 127, 3, 0);
+        checkReadPattern (reader, expected, numChannels, numSamples, 64, 1, 1);
+    }
+
+    void testIntegerFormat (const int bitsPerSample, const int numChannels, const int numSamples,
+                            const bool readViaFile)
+    {
+        WavAudioFormat format;
+        Random r;
+        const int bytesPerSample = bitsPerSample / 8;
+
+        HeapBlock<int> source ((size_t) (numChannels * numSamples));
+
+        for (int i = 0; i < numChannels * numSamples; ++i)
+            source[i] = r.nextInt();
+
+        MemoryBlock fileData;
+
+        {
+            ScopedPointer<AudioFormatWriter> writer (format.createWriterFor (new MemoryOutputStream (fileData, false),
+                                                                             44100.0, (unsigned int) numChannels,
+                                                                             bitsPerSample, StringPairArray(), 0));
+            expect (writer != nullptr);
+
+            if (writer == nullptr)
+                return;
+
+            // write in awkwardly-sized blocks so the conversion tails get exercised
+            for (int start = 0; start < numSamples;)
+            {
+                const int num = jmin (123, numSamples - start);
+                const int* chans [4] = { nullptr, nullptr, nullptr, nullptr };
+
+                for (int c = 0; c < numChannels; ++c)
+                    chans[c] = source + (c * numSamples + start);
+
+                expect (writer->write (chans, num));
+                start += num;
+            }
+        }
+
+        // The memory-mapped read path - the one that hands a whole file to the
+        // conversion loops in a single call, which is how the streaming-store
+        // code gets reached - only kicks in for a FileInputStream on a large
+        // enough file, so the big cases round-trip their data through disk.
+        File tempFile;
+
+        if (readViaFile)
+        {
+            tempFile = File::getSpecialLocation (File::tempDirectory)
+                           .getNonexistentChildFile ("juce_WavFormatTest", ".wav");
+            expect (tempFile.replaceWithData (fileData.getData(), fileData.getSize()));
+        }
+
+        ScopedPointer<WavAudioFormatReader> reader
+            (static_cast <WavAudioFormatReader*> (readViaFile
+                ? format.createReaderFor (tempFile.createInputStream(), true)
+                : format.createReaderFor (new MemoryInputStream (fileData, false), true)));
+        expect (reader != nullptr);
+
+        if (reader == nullptr)
+        {
+            tempFile.deleteFile();
+            return;
+        }
+
+        expectEquals ((int) reader->numChannels, numChannels);
+        expectEquals ((int) reader->bitsPerSample, bitsPerSample);
+        expectEquals ((int) reader->lengthInSamples, numSamples);
+
+        const uint8* const rawData = addBytesToPointer (static_cast <const uint8*> (fileData.getData()),
+                                                        reader->dataChunkStart);
+
+        // check the encoded bytes directly, and build the reference decode
+        HeapBlock<int> expected ((size_t) (numChannels * numSamples));
+        bool encodingMatches = true;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            for (int c = 0; c < numChannels; ++c)
+            {
+                const uint8* const frame = rawData + (i * numChannels + c) * bytesPerSample;
+                const uint32 s = (uint32) source [c * numSamples + i];
+                bool ok = false;
+
+                switch (bitsPerSample)
+                {
+                    case 8:   ok = frame[0] == (uint8) ((s >> 24) ^ 0x80); break;
+                    case 16:  ok = ByteOrder::littleEndianShort (frame) == (uint16) (s >> 16); break;
+                    case 24:  ok = ((uint32) ByteOrder::littleEndian24Bit ((const char*) frame) & 0xffffff) == ((s >> 8) & 0xffffff); break;
+                    default:  break;
+                }
+
+                encodingMatches = encodingMatches && ok;
+                expected [c * numSamples + i] = decodeSample (frame, bitsPerSample);
+            }
+        }
+
+        expect (encodingMatches);
+        checkAgainstReference (*reader, expected, numChannels, numSamples);
+
+        reader = nullptr;
+        tempFile.deleteFile();
+    }
+
+    void testFloatFormat (const int numChannels, const int numSamples, const bool readViaFile)
+    {
+        WavAudioFormat format;
+        Random r;
+        AudioSampleBuffer buffer (numChannels, numSamples);
+
+        for (int c = 0; c < numChannels; ++c)
+        {
+            float* const chan = buffer.getSampleData (c);
+
+            for (int i = 0; i < numSamples; ++i)
+                chan[i] = r.nextFloat() * 2.0f - 1.0f;
+        }
+
+        MemoryBlock fileData;
+
+        {
+            ScopedPointer<AudioFormatWriter> writer (format.createWriterFor (new MemoryOutputStream (fileData, false),
+                                                                             44100.0, (unsigned int) numChannels,
+                                                                             32, StringPairArray(), 0));
+            expect (writer != nullptr);
+
+            if (writer == nullptr)
+                return;
+
+            expect (writer->writeFromAudioSampleBuffer (buffer, 0, numSamples));
+        }
+
+        // as in testIntegerFormat, only a file-backed reader can memory-map
+        // the data and feed whole-file reads to the streaming stores
+        File tempFile;
+
+        if (readViaFile)
+        {
+            tempFile = File::getSpecialLocation (File::tempDirectory)
+                           .getNonexistentChildFile ("juce_WavFormatTest", ".wav");
+            expect (tempFile.replaceWithData (fileData.getData(), fileData.getSize()));
+        }
+
+        ScopedPointer<WavAudioFormatReader> reader
+            (static_cast <WavAudioFormatReader*> (readViaFile
+                ? format.createReaderFor (tempFile.createInputStream(), true)
+                : format.createReaderFor (new MemoryInputStream (fileData, false), true)));
+        expect (reader != nullptr);
+
+        if (reader == nullptr)
+        {
+            tempFile.deleteFile();
+            return;
+        }
+
+        expect (reader->usesFloatingPointData);
+
+        const uint8* const rawData = addBytesToPointer (static_cast <const uint8*> (fileData.getData()),
+                                                        reader->dataChunkStart);
+
+        HeapBlock<int> expected ((size_t) (numChannels * numSamples));
+        bool encodingMatches = true;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            for (int c = 0; c < numChannels; ++c)
+            {
+                const uint8* const frame = rawData + (i * numChannels + c) * 4;
+                int originalBits = 0;
+                memcpy (&originalBits, buffer.getSampleData (c) + i, sizeof (originalBits));
+
+                encodingMatches = encodingMatches && originalBits == (int) ByteOrder::littleEndianInt (frame);
+                expected [c * numSamples + i] = decodeSample (frame, 32);
+            }
+        }
+
+        expect (encodingMatches);
+        checkAgainstReference (*reader, expected, numChannels, numSamples);
+
+        reader = nullptr;
+        tempFile.deleteFile();
+    }
+
+    //==============================================================================
+    static void setBwavValues (StringPairArray& values, const String& description, const String& history)
+    {
+        values.set (WavAudioFormat::bwavDescription, description);
+        values.set (WavAudioFormat::bwavOriginator, "unit test");
+        values.set (WavAudioFormat::bwavOriginatorRef, "ref1");
+        values.set (WavAudioFormat::bwavOriginationDate, "2013-06-07");
+        values.set (WavAudioFormat::bwavOriginationTime, "12:34:56");
+        values.set (WavAudioFormat::bwavTimeReference, "123456789");
+        values.set (WavAudioFormat::bwavCodingHistory, history);
+    }
+
+    void checkMetadataRewrite (WavAudioFormat& format, const File& file, const HeapBlock<int>& source,
+                               const int numChannels, const int numSamples,
+                               const String& description, const String& history)
+    {
+        StringPairArray newMetadata;
+        setBwavValues (newMetadata, description, history);
+
+        expect (format.replaceMetadataInFile (file, newMetadata));
+
+        ScopedPointer<AudioFormatReader> reader (format.createReaderFor (file.createInputStream(), true));
+        expect (reader != nullptr);
+
+        if (reader == nullptr)
+            return;
+
+        expectEquals (reader->metadataValues [WavAudioFormat::bwavDescription], description);
+        expectEquals (reader->metadataValues [WavAudioFormat::bwavCodingHistory], history);
+        expectEquals ((int) reader->lengthInSamples, numSamples);
+
+        // the audio data has to survive the rewrite untouched
+        HeapBlock<int> read ((size_t) (numChannels * numSamples), true);
+        int* dest [4] = { nullptr, nullptr, nullptr, nullptr };
+
+        for (int c = 0; c < numChannels; ++c)
+            dest[c] = read + c * numSamples;
+
+        reader->readSamples (dest, numChannels, 0, 0, numSamples);
+
+        bool audioIntact = true;
+
+        for (int c = 0; c < numChannels; ++c)
+            for (int i = 0; i < numSamples; ++i)
+                audioIntact = audioIntact && read [c * numSamples + i] == (int) (source [c * numSamples + i] & 0xffff0000);
+
+        expect (audioIntact);
+    }
+
+    void testMetadataReplacement()
+    {
+        WavAudioFormat format;
+        Random r;
+        const File file (File::getSpecialLocation (File::tempDirectory)
+                           .getNonexistentChildFile ("juce_WavFormatTest", ".wav"));
+
+        const int numChannels = 2, numSamples = 4000;
+        HeapBlock<int> source ((size_t) (numChannels * numSamples));
+
+        for (int i = 0; i < numChannels * numSamples; ++i)
+            source[i] = r.nextInt();
+
+        {
+            StringPairArray metadata;
+            setBwavValues (metadata, "first description", String::repeatedString ("a", 400));
+
+            ScopedPointer<AudioFormatWriter> writer (format.createWriterFor (file.createOutputStream(), 44100.0,
+                                                                             (unsigned int) numChannels, 16, metadata, 0));
+            expect (writer != nullptr);
+
+            if (writer == nullptr)
+                return;
+
+            const int* chans [4] = { source, source + numSamples, nullptr, nullptr };
+            expect (writer->write (chans, numSamples));
+        }
+
+        // same-size, smaller (padded in place) and larger (tail shifted in place)
+        checkMetadataRewrite (format, file, source, numChannels, numSamples, "second description", String::repeatedString ("b", 400));
+        checkMetadataRewrite (format, file, source, numChannels, numSamples, "third description",  "short");
+        checkMetadataRewrite (format, file, source, numChannels, numSamples, "fourth description", String::repeatedString ("c", 3000));
+
+        file.deleteFile();
+    }
+
+    //==============================================================================
+    void runTest() override
+    {
+        beginTest ("Integer sample conversion vs scalar reference");
+
+        const int depths[]  = { 8, 16, 24 };
+        const int lengths[] = { 3, 127, 1000 };
+
+        for (int d = 0; d < numElementsInArray (depths); ++d)
+            for (int chans = 1; chans <= 2; ++chans)
+                for (int l = 0; l < numElementsInArray (lengths); ++l)
+                    testIntegerFormat (depths[d], chans, lengths[l], false);
+
+        // big enough to be memory-mapped when read from disk, and to cross the
+        // frame threshold for the non-temporal stores in a whole-file read
+        testIntegerFormat (16, 2, 300000, true);
+
+        beginTest ("Float sample conversion vs scalar reference");
+        testFloatFormat (1, 127, false);
+        testFloatFormat (2, 1000, false);
+        testFloatFormat (2, 300000, true);
+
+        beginTest ("In-place metadata replacement");
+        testMetadataReplacement();
+    }
+};
+
+static WavAudioFormatTests wavAudioFormatTests;
+
+#endif
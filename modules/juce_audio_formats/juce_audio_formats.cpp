@@ -38,6 +38,41 @@
 #include "../juce_core/native/juce_BasicNativeHeaders.h"
 #include "juce_audio_formats.h"
 
+//==============================================================================
+#ifndef JUCE_USE_SSE_INTRINSICS
+ #define JUCE_USE_SSE_INTRINSICS 1
+#endif
+
+#if ! JUCE_INTEL
+ #undef JUCE_USE_SSE_INTRINSICS
+#endif
+
+// Older 32-bit x86 toolchains reject <emmintrin.h> unless the compiler itself
+// is targeting SSE2, so being on an Intel chip isn't enough by itself.
+#if ! (defined (__SSE2__) || defined (_M_X64) || defined (_M_AMD64) || (defined (_M_IX86_FP) && _M_IX86_FP >= 2))
+ #undef JUCE_USE_SSE_INTRINSICS
+#endif
+
+#if JUCE_USE_SSE_INTRINSICS
+ #include <emmintrin.h>
+ #ifdef __SSSE3__
+  #include <tmmintrin.h>
+ #endif
+#endif
+
+//==============================================================================
+#ifndef JUCE_USE_ARM_NEON
+ #define JUCE_USE_ARM_NEON 1
+#endif
+
+#if JUCE_BIG_ENDIAN || ! (defined (__ARM_NEON__) || defined (__ARM_NEON))
+ #undef JUCE_USE_ARM_NEON
+#endif
+
+#if JUCE_USE_ARM_NEON
+ #include <arm_neon.h>
+#endif
+
 //==============================================================================
 #if JUCE_MAC
  #define Point CarbonDummyPointName
@@ -305,6 +305,7 @@ namespace juce
  #define JUCE_COMPILER_SUPPORTS_NOEXCEPT 1
  #define JUCE_COMPILER_SUPPORTS_NULLPTR 1
  #define JUCE_COMPILER_SUPPORTS_MOVE_SEMANTICS 1
+ #define JUCE_COMPILER_SUPPORTS_VARIADIC_TEMPLATES 1
 
  #if (__GNUC__ * 100 + __GNUC_MINOR__) >= 407 && ! defined (JUCE_COMPILER_SUPPORTS_OVERRIDE_AND_FINAL)
   #define JUCE_COMPILER_SUPPORTS_OVERRIDE_AND_FINAL 1
@@ -324,6 +325,10 @@ namespace juce
   #define JUCE_COMPILER_SUPPORTS_MOVE_SEMANTICS 1
  #endif
 
+ #if __has_feature (cxx_variadic_templates)
+  #define JUCE_COMPILER_SUPPORTS_VARIADIC_TEMPLATES 1
+ #endif
+
  #ifndef JUCE_COMPILER_SUPPORTS_OVERRIDE_AND_FINAL
   #define JUCE_COMPILER_SUPPORTS_OVERRIDE_AND_FINAL 1
  #endif
@@ -342,6 +347,10 @@ namespace juce
  #define JUCE_COMPILER_SUPPORTS_OVERRIDE_AND_FINAL 1
 #endif
 
+#if defined (_MSC_VER) && _MSC_VER >= 1800
+ #define JUCE_COMPILER_SUPPORTS_VARIADIC_TEMPLATES 1
+#endif
+
 //==============================================================================
 // Declare some fake versions of nullptr and noexcept, for older compilers:
 #if ! (DOXYGEN || JUCE_COMPILER_SUPPORTS_NOEXCEPT)
@@ -26,6 +26,102 @@
 #define JUCE_LISTENERLIST_H_INCLUDED
 
 
+//==============================================================================
+/**
+    A minimal array used as the default backing store for a ListenerList.
+
+    The first few elements live in storage inside the object itself, so the
+    common case of a list holding just a handful of listeners never touches the
+    heap, and iterating it doesn't chase a pointer to a separate block. Once the
+    inline space is exceeded, the contents spill into a heap allocation in the
+    usual way.
+
+    Only the parts of the Array interface that ListenerList needs are provided,
+    and the element type is expected to be a plain pointer.
+
+    @see ListenerList
+*/
+template <class ElementType, int inlineCapacity = 4>
+class InlineListenerArray
+{
+public:
+    InlineListenerArray() noexcept
+        : data (inlineStorage), numUsed (0), capacity (inlineCapacity)
+    {
+    }
+
+    ~InlineListenerArray()
+    {
+    }
+
+    int size() const noexcept                   { return numUsed; }
+
+    ElementType getUnchecked (const int index) const noexcept
+    {
+        jassert (isPositiveAndBelow (index, numUsed));
+        return data [index];
+    }
+
+    bool contains (const ElementType elementToLookFor) const noexcept
+    {
+        for (int i = 0; i < numUsed; ++i)
+            if (data[i] == elementToLookFor)
+                return true;
+
+        return false;
+    }
+
+    void addIfNotAlreadyThere (const ElementType newElement)
+    {
+        if (! contains (newElement))
+        {
+            if (numUsed == capacity)
+                grow();
+
+            data [numUsed++] = newElement;
+        }
+    }
+
+    void removeFirstMatchingValue (const ElementType elementToRemove) noexcept
+    {
+        for (int i = 0; i < numUsed; ++i)
+        {
+            if (data[i] == elementToRemove)
+            {
+                --numUsed;
+
+                for (; i < numUsed; ++i)
+                    data[i] = data [i + 1];
+
+                break;
+            }
+        }
+    }
+
+    void clear() noexcept                       { numUsed = 0; }
+
+private:
+    void grow()
+    {
+        const int newCapacity = capacity * 2;
+
+        HeapBlock<ElementType> newStorage ((size_t) newCapacity);
+        memcpy (newStorage, data, (size_t) numUsed * sizeof (ElementType));
+
+        heapStorage.swapWith (newStorage);
+        data = heapStorage;
+        capacity = newCapacity;
+    }
+
+    ElementType* data;
+    int numUsed, capacity;
+    HeapBlock<ElementType> heapStorage;
+    ElementType inlineStorage [inlineCapacity];
+
+    JUCE_DECLARE_NON_COPYABLE (InlineListenerArray)
+};
+
+
 //==============================================================================
 /**
     Holds a set of objects and can invoke a member function callback on each object
@@ -65,7 +161,7 @@
     ListenerList::DummyBailOutChecker, which is a dummy checker that always returns false.
 */
 template <class ListenerClass,
-          class ArrayType = Array <ListenerClass*> >
+          class ArrayType = InlineListenerArray <ListenerClass*> >
 class ListenerList
 {
     // Horrible macros required to support VC7..
@@ -142,10 +238,72 @@ public:
     }
 
     //==============================================================================
+   #if JUCE_COMPILER_SUPPORTS_VARIADIC_TEMPLATES || defined (DOXYGEN)
+    /** Calls a member function on each listener in the list, with the given parameters. */
+    template <typename... MethodParams, typename... Params>
+    void call (void (ListenerClass::*callbackFunction) (MethodParams...), Params&&... params)
+    {
+        const int numListeners = listeners.size();
+
+        if (numListeners == 0)
+            return;
+
+        if (numListeners == 1)
+        {
+            (listeners.getUnchecked (0)->*callbackFunction) (params...);
+            return;
+        }
+
+        for (Iterator<DummyBailOutChecker, ThisType> iter (*this); iter.next();)
+            (iter.getListener()->*callbackFunction) (params...);
+    }
+
+    /** Calls a member function on each listener in the list, with the given parameters
+        and a bail-out-checker.
+        See the class description for info about writing a bail-out checker. */
+    template <class BailOutCheckerType, typename... MethodParams, typename... Params>
+    void callChecked (const BailOutCheckerType& bailOutChecker,
+                      void (ListenerClass::*callbackFunction) (MethodParams...),
+                      Params&&... params)
+    {
+        const int numListeners = listeners.size();
+
+        if (numListeners == 0)
+            return;
+
+        if (numListeners == 1)
+        {
+            if (! bailOutChecker.shouldBailOut())
+                (listeners.getUnchecked (0)->*callbackFunction) (params...);
+
+            return;
+        }
+
+        for (Iterator<BailOutCheckerType, ThisType> iter (*this); iter.next (bailOutChecker);)
+            (iter.getListener()->*callbackFunction) (params...);
+    }
+
+   #else
+    //==============================================================================
+    // For compilers which can't do variadic templates, the 0..6 parameter
+    // versions have to be expanded out by hand..
+
     /** Calls a member function on each listener in the list, with no parameters. */
     void call (void (ListenerClass::*callbackFunction) ())
     {
-        callChecked (static_cast <const DummyBailOutChecker&> (DummyBailOutChecker()), callbackFunction);
+        const int numListeners = listeners.size();
+
+        if (numListeners == 0)
+            return;
+
+        if (numListeners == 1)
+        {
+            (listeners.getUnchecked (0)->*callbackFunction) ();
+            return;
+        }
+
+        for (Iterator<DummyBailOutChecker, ThisType> iter (*this); iter.next();)
+            (iter.getListener()->*callbackFunction) ();
     }
 
     /** Calls a member function on each listener in the list, with no parameters and a bail-out-checker.
@@ -154,6 +312,19 @@ public:
     void callChecked (const BailOutCheckerType& bailOutChecker,
                       void (ListenerClass::*callbackFunction) ())
     {
+        const int numListeners = listeners.size();
+
+        if (numListeners == 0)
+            return;
+
+        if (numListeners == 1)
+        {
+            if (! bailOutChecker.shouldBailOut())
+                (listeners.getUnchecked (0)->*callbackFunction) ();
+
+            return;
+        }
+
         for (Iterator<BailOutCheckerType, ThisType> iter (*this); iter.next (bailOutChecker);)
             (iter.getListener()->*callbackFunction) ();
     }
@@ -163,6 +334,17 @@ public:
     template <LL_TEMPLATE(1)>
     void call (void (ListenerClass::*callbackFunction) (P1), LL_PARAM(1))
     {
+        const int numListeners = listeners.size();
+
+        if (numListeners == 0)
+            return;
+
+        if (numListeners == 1)
+        {
+            (listeners.getUnchecked (0)->*callbackFunction) (param1);
+            return;
+        }
+
         for (Iterator<DummyBailOutChecker, ThisType> iter (*this); iter.next();)
             (iter.getListener()->*callbackFunction) (param1);
     }
@@ -174,6 +356,19 @@ public:
                       void (ListenerClass::*callbackFunction) (P1),
                       LL_PARAM(1))
     {
+        const int numListeners = listeners.size();
+
+        if (numListeners == 0)
+            return;
+
+        if (numListeners == 1)
+        {
+            if (! bailOutChecker.shouldBailOut())
+                (listeners.getUnchecked (0)->*callbackFunction) (param1);
+
+            return;
+        }
+
         for (Iterator<BailOutCheckerType, ThisType> iter (*this); iter.next (bailOutChecker);)
             (iter.getListener()->*callbackFunction) (param1);
     }
@@ -184,6 +379,17 @@ public:
     void call (void (ListenerClass::*callbackFunction) (P1, P2),
                LL_PARAM(1), LL_PARAM(2))
     {
+        const int numListeners = listeners.size();
+
+        if (numListeners == 0)
+            return;
+
+        if (numListeners == 1)
+        {
+            (listeners.getUnchecked (0)->*callbackFunction) (param1, param2);
+            return;
+        }
+
         for (Iterator<DummyBailOutChecker, ThisType> iter (*this); iter.next();)
             (iter.getListener()->*callbackFunction) (param1, param2);
     }
@@ -195,6 +401,19 @@ public:
                       void (ListenerClass::*callbackFunction) (P1, P2),
                       LL_PARAM(1), LL_PARAM(2))
     {
+        const int numListeners = listeners.size();
+
+        if (numListeners == 0)
+            return;
+
+        if (numListeners == 1)
+        {
+            if (! bailOutChecker.shouldBailOut())
+                (listeners.getUnchecked (0)->*callbackFunction) (param1, param2);
+
+            return;
+        }
+
         for (Iterator<BailOutCheckerType, ThisType> iter (*this); iter.next (bailOutChecker);)
             (iter.getListener()->*callbackFunction) (param1, param2);
     }
@@ -205,6 +424,17 @@ public:
     void call (void (ListenerClass::*callbackFunction) (P1, P2, P3),
                LL_PARAM(1), LL_PARAM(2), LL_PARAM(3))
     {
+        const int numListeners = listeners.size();
+
+        if (numListeners == 0)
+            return;
+
+        if (numListeners == 1)
+        {
+            (listeners.getUnchecked (0)->*callbackFunction) (param1, param2, param3);
+            return;
+        }
+
         for (Iterator<DummyBailOutChecker, ThisType> iter (*this); iter.next();)
             (iter.getListener()->*callbackFunction) (param1, param2, param3);
     }
@@ -216,6 +446,19 @@ public:
                       void (ListenerClass::*callbackFunction) (P1, P2, P3),
                       LL_PARAM(1), LL_PARAM(2), LL_PARAM(3))
     {
+        const int numListeners = listeners.size();
+
+        if (numListeners == 0)
+            return;
+
+        if (numListeners == 1)
+        {
+            if (! bailOutChecker.shouldBailOut())
+                (listeners.getUnchecked (0)->*callbackFunction) (param1, param2, param3);
+
+            return;
+        }
+
         for (Iterator<BailOutCheckerType, ThisType> iter (*this); iter.next (bailOutChecker);)
             (iter.getListener()->*callbackFunction) (param1, param2, param3);
     }
@@ -226,6 +469,17 @@ public:
     void call (void (ListenerClass::*callbackFunction) (P1, P2, P3, P4),
                LL_PARAM(1), LL_PARAM(2), LL_PARAM(3), LL_PARAM(4))
     {
+        const int numListeners = listeners.size();
+
+        if (numListeners == 0)
+            return;
+
+        if (numListeners == 1)
+        {
+            (listeners.getUnchecked (0)->*callbackFunction) (param1, param2, param3, param4);
+            return;
+        }
+
         for (Iterator<DummyBailOutChecker, ThisType> iter (*this); iter.next();)
             (iter.getListener()->*callbackFunction) (param1, param2, param3, param4);
     }
@@ -237,6 +491,19 @@ public:
                       void (ListenerClass::*callbackFunction) (P1, P2, P3, P4),
                       LL_PARAM(1), LL_PARAM(2), LL_PARAM(3), LL_PARAM(4))
     {
+        const int numListeners = listeners.size();
+
+        if (numListeners == 0)
+            return;
+
+        if (numListeners == 1)
+        {
+            if (! bailOutChecker.shouldBailOut())
+                (listeners.getUnchecked (0)->*callbackFunction) (param1, param2, param3, param4);
+
+            return;
+        }
+
         for (Iterator<BailOutCheckerType, ThisType> iter (*this); iter.next (bailOutChecker);)
             (iter.getListener()->*callbackFunction) (param1, param2, param3, param4);
     }
@@ -247,6 +514,17 @@ public:
     void call (void (ListenerClass::*callbackFunction) (P1, P2, P3, P4, P5),
                LL_PARAM(1), LL_PARAM(2), LL_PARAM(3), LL_PARAM(4), LL_PARAM(5))
     {
+        const int numListeners = listeners.size();
+
+        if (numListeners == 0)
+            return;
+
+        if (numListeners == 1)
+        {
+            (listeners.getUnchecked (0)->*callbackFunction) (param1, param2, param3, param4, param5);
+            return;
+        }
+
         for (Iterator<DummyBailOutChecker, ThisType> iter (*this); iter.next();)
             (iter.getListener()->*callbackFunction) (param1, param2, param3, param4, param5);
     }
@@ -258,6 +536,19 @@ public:
                       void (ListenerClass::*callbackFunction) (P1, P2, P3, P4, P5),
                       LL_PARAM(1), LL_PARAM(2), LL_PARAM(3), LL_PARAM(4), LL_PARAM(5))
     {
+        const int numListeners = listeners.size();
+
+        if (numListeners == 0)
+            return;
+
+        if (numListeners == 1)
+        {
+            if (! bailOutChecker.shouldBailOut())
+                (listeners.getUnchecked (0)->*callbackFunction) (param1, param2, param3, param4, param5);
+
+            return;
+        }
+
         for (Iterator<BailOutCheckerType, ThisType> iter (*this); iter.next (bailOutChecker);)
             (iter.getListener()->*callbackFunction) (param1, param2, param3, param4, param5);
     }
@@ -268,6 +559,17 @@ public:
     void call (void (ListenerClass::*callbackFunction) (P1, P2, P3, P4, P5, P6),
                LL_PARAM(1), LL_PARAM(2), LL_PARAM(3), LL_PARAM(4), LL_PARAM(5), LL_PARAM(6))
     {
+        const int numListeners = listeners.size();
+
+        if (numListeners == 0)
+            return;
+
+        if (numListeners == 1)
+        {
+            (listeners.getUnchecked (0)->*callbackFunction) (param1, param2, param3, param4, param5, param6);
+            return;
+        }
+
         for (Iterator<DummyBailOutChecker, ThisType> iter (*this); iter.next();)
             (iter.getListener()->*callbackFunction) (param1, param2, param3, param4, param5, param6);
     }
@@ -279,10 +581,23 @@ public:
                       void (ListenerClass::*callbackFunction) (P1, P2, P3, P4, P5, P6),
                       LL_PARAM(1), LL_PARAM(2), LL_PARAM(3), LL_PARAM(4), LL_PARAM(5), LL_PARAM(6))
     {
+        const int numListeners = listeners.size();
+
+        if (numListeners == 0)
+            return;
+
+        if (numListeners == 1)
+        {
+            if (! bailOutChecker.shouldBailOut())
+                (listeners.getUnchecked (0)->*callbackFunction) (param1, param2, param3, param4, param5, param6);
+
+            return;
+        }
+
         for (Iterator<BailOutCheckerType, ThisType> iter (*this); iter.next (bailOutChecker);)
             (iter.getListener()->*callbackFunction) (param1, param2, param3, param4, param5, param6);
     }
-
+   #endif
 
     //==============================================================================
     /** A dummy bail-out checker that always returns false.
@@ -310,15 +625,24 @@ public:
         //==============================================================================
         bool next() noexcept
         {
-            if (index <= 0)
-                return false;
-
-            const int listSize = list.size();
-
-            if (--index < listSize)
+            // The backward walk is what makes it safe for a listener to remove
+            // itself during its callback, so the size has to be re-checked on
+            // each step - but in the normal case where the list hasn't changed,
+            // this is a single unsigned comparison per listener.
+            const int newIndex = index - 1;
+
+            if (isPositiveAndBelow (newIndex, list.size()))
+            {
+                index = newIndex;
                 return true;
+            }
+
+            if (newIndex < 0)
+                return false;
 
-            index = listSize - 1;
+            // listeners were removed during the iteration, so clamp back down
+            // to the end of what's left
+            index = list.size() - 1;
             return index >= 0;
         }
 
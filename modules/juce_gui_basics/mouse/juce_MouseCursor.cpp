@@ -42,22 +42,54 @@ private:
     JUCE_DECLARE_NON_COPYABLE (CustomMouseCursorInfo)
 };
 
+// A 64-bit FNV-1a over an image's pixels. Images are explicitly shared and can
+// be redrawn in place, so a cache of cursors made from them can't treat pointer
+// identity as meaning "the same picture" - it has to look at the content.
+static uint64 hashImagePixels (const Image& image) noexcept
+{
+    uint64 hash = (uint64) literal64bit (0xcbf29ce484222325);
+    const uint64 prime = (uint64) literal64bit (0x100000001b3);
+
+    const Image::BitmapData bitmap (image, Image::BitmapData::readOnly);
+    const int lineSize = bitmap.width * bitmap.pixelStride;
+
+    hash = (hash ^ (uint64) (uint32) bitmap.width)  * prime;
+    hash = (hash ^ (uint64) (uint32) bitmap.height) * prime;
+    hash = (hash ^ (uint64) (uint32) image.getFormat()) * prime;
+
+    for (int y = 0; y < bitmap.height; ++y)
+    {
+        const uint8* const line = bitmap.getLinePointer (y);
+
+        for (int i = 0; i < lineSize; ++i)
+            hash = (hash ^ line[i]) * prime;
+    }
+
+    return hash;
+}
+
 class MouseCursor::SharedCursorHandle
 {
 public:
     explicit SharedCursorHandle (const MouseCursor::StandardCursorType type)
-        : handle (createStandardMouseCursor (type)),
-          refCount (1),
-          standardType (type),
-          isStandard (true)
+        : standardType (type),
+          isStandard (true),
+          imageHash (0),
+          hotSpot (0, 0),
+          scaleFactor (1.0f),
+          handle (createStandardMouseCursor (type)),
+          refCount (1)
     {
     }
 
-    SharedCursorHandle (const Image& image, Point<int> hotSpot, const float scaleFactor)
-        : handle (CustomMouseCursorInfo (image, hotSpot, scaleFactor).create()),
-          refCount (1),
-          standardType (MouseCursor::NormalCursor),
-          isStandard (false)
+    SharedCursorHandle (const Image& im, Point<int> hs, const float scale, const uint64 imHash)
+        : standardType (MouseCursor::NormalCursor),
+          isStandard (false),
+          imageHash (imHash),
+          hotSpot (hs),
+          scaleFactor (scale),
+          handle (CustomMouseCursorInfo (im, hs, scale).create()),
+          refCount (1)
     {
     }
 
@@ -72,7 +104,7 @@ public:
 
         const SpinLock::ScopedLockType sl (lock);
 
-        SharedCursorHandle*& c = getSharedCursor (type);
+        SharedCursorHandle*& c = standardCursors [type];
 
         if (c == nullptr)
             c = new SharedCursorHandle (type);
@@ -82,6 +114,29 @@ public:
         return c;
     }
 
+    static SharedCursorHandle* createCustom (const Image& image, Point<int> hotSpot, float scaleFactor)
+    {
+        // Drag-and-drop gestures tend to recreate the same custom cursor over
+        // and over, so the most recently created one is kept findable for as
+        // long as it's alive, keyed on the content of its pixels - hashing
+        // them costs far less than pushing them through the window server.
+        const uint64 imageHash = hashImagePixels (image);
+
+        const SpinLock::ScopedLockType sl (lock);
+
+        SharedCursorHandle* const c = lastCustomCursor;
+
+        if (c != nullptr
+             && c->imageHash == imageHash
+             && c->hotSpot == hotSpot
+             && c->scaleFactor == scaleFactor)
+            return c->retain();
+
+        SharedCursorHandle* const newCursor = new SharedCursorHandle (image, hotSpot, scaleFactor, imageHash);
+        lastCustomCursor = newCursor;
+        return newCursor;
+    }
+
     bool isStandardType (MouseCursor::StandardCursorType type) const noexcept
     {
         return type == standardType && isStandard;
@@ -95,37 +150,52 @@ public:
 
     void release()
     {
-        if (--refCount == 0)
-        {
-            if (isStandard)
-            {
-                const SpinLock::ScopedLockType sl (lock);
-                getSharedCursor (standardType) = nullptr;
-            }
-
-            delete this;
-        }
+        // The final decrement must happen under the same lock that the lookup
+        // tables use to retain handles, as otherwise another thread could
+        // revive this one from a table while it's on its way to deletion.
+        const SpinLock::ScopedLockType sl (lock);
+
+        if (--refCount > 0)
+            return;
+
+        if (isStandard)
+            standardCursors [standardType] = nullptr;
+        else if (lastCustomCursor == this)
+            lastCustomCursor = nullptr;
+
+        delete this;
     }
 
     void* getHandle() const noexcept        { return handle; }
 
 private:
-    void* const handle;
-    Atomic <int> refCount;
+    // The constant fields are grouped ahead of the refcount, which is the only
+    // thing that's written after construction. Note that the object is small
+    // enough to sit on a single cache line, so this is just keeping the layout
+    // tidy - it doesn't isolate the refcount traffic from the other fields.
     const MouseCursor::StandardCursorType standardType;
     const bool isStandard;
+    const uint64 imageHash;
+    const Point<int> hotSpot;
+    const float scaleFactor;
+    void* const handle;
+    Atomic <int> refCount;
     static SpinLock lock;
 
-    static SharedCursorHandle*& getSharedCursor (const MouseCursor::StandardCursorType type)
-    {
-        static SharedCursorHandle* cursors [MouseCursor::NumStandardCursorTypes] = {};
-        return cursors [type];
-    }
+    // One slot per standard cursor type, so looking one up is just an indexed
+    // load under the lock.
+    static SharedCursorHandle* standardCursors [MouseCursor::NumStandardCursorTypes];
+
+    // The most recently created custom cursor, so that building another one
+    // from the same image doesn't have to go back to the window server.
+    static SharedCursorHandle* lastCustomCursor;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SharedCursorHandle)
 };
 
 SpinLock MouseCursor::SharedCursorHandle::lock;
+MouseCursor::SharedCursorHandle* MouseCursor::SharedCursorHandle::standardCursors [MouseCursor::NumStandardCursorTypes] = {};
+MouseCursor::SharedCursorHandle* MouseCursor::SharedCursorHandle::lastCustomCursor = nullptr;
 
 //==============================================================================
 MouseCursor::MouseCursor()
@@ -139,12 +209,12 @@ MouseCursor::MouseCursor (const StandardCursorType type)
 }
 
 MouseCursor::MouseCursor (const Image& image, const int hotSpotX, const int hotSpotY)
-    : cursorHandle (new SharedCursorHandle (image, Point<int> (hotSpotX, hotSpotY), 1.0f))
+    : cursorHandle (SharedCursorHandle::createCustom (image, Point<int> (hotSpotX, hotSpotY), 1.0f))
 {
 }
 
 MouseCursor::MouseCursor (const Image& image, const int hotSpotX, const int hotSpotY, float scaleFactor)
-    : cursorHandle (new SharedCursorHandle (image, Point<int> (hotSpotX, hotSpotY), scaleFactor))
+    : cursorHandle (SharedCursorHandle::createCustom (image, Point<int> (hotSpotX, hotSpotY), scaleFactor))
 {
 }
 
@@ -185,20 +255,12 @@ MouseCursor& MouseCursor::operator= (MouseCursor&& other) noexcept
 }
 #endif
 
-bool MouseCursor::operator== (const MouseCursor& other) const noexcept
-{
-    return getHandle() == other.getHandle();
-}
-
 bool MouseCursor::operator== (StandardCursorType type) const noexcept
 {
     return cursorHandle != nullptr ? cursorHandle->isStandardType (type)
                                    : (type == NormalCursor);
 }
 
-bool MouseCursor::operator!= (const MouseCursor& other) const noexcept  { return ! operator== (other); }
-bool MouseCursor::operator!= (StandardCursorType type)  const noexcept  { return ! operator== (type); }
-
 void* MouseCursor::getHandle() const noexcept
 {
     return cursorHandle != nullptr ? cursorHandle->getHandle() : nullptr;
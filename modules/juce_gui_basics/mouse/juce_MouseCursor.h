@@ -122,25 +122,25 @@ public:
 
     /** Checks whether two mouse cursors are the same.
 
-        For custom cursors, two cursors created from the same image won't be
-        recognised as the same, only MouseCursor objects that have been
-        copied from the same object.
+        Custom cursors compare as the same if they were copied from the same
+        object, or created from images with identical pixels and the same
+        hot-spot, in which case they may share a native cursor.
     */
-    bool operator== (const MouseCursor&) const noexcept;
+    bool operator== (const MouseCursor& other) const noexcept   { return getHandle() == other.getHandle(); }
 
     /** Checks whether two mouse cursors are the same.
 
-        For custom cursors, two cursors created from the same image won't be
-        recognised as the same, only MouseCursor objects that have been
-        copied from the same object.
+        Custom cursors compare as the same if they were copied from the same
+        object, or created from images with identical pixels and the same
+        hot-spot, in which case they may share a native cursor.
     */
-    bool operator!= (const MouseCursor&) const noexcept;
+    bool operator!= (const MouseCursor& other) const noexcept   { return ! operator== (other); }
 
     /** Checks whether this cursor is of the standard type mentioned. */
     bool operator== (StandardCursorType type) const noexcept;
 
     /** Checks whether this cursor is of the standard type mentioned. */
-    bool operator!= (StandardCursorType type) const noexcept;
+    bool operator!= (StandardCursorType type) const noexcept    { return ! operator== (type); }
 
     //==============================================================================
     /** Makes the system show its default 'busy' cursor.